@@ -22,7 +22,8 @@ string getCartFilePath() {
 }
 
 //Adding an item to the cart with a specific quantity
-bool ShoppingCart::addItem(Product* product, int quantity) {
+bool ShoppingCart::addItem(uint32_t productId, int quantity) {
+    Product* product = catalog.getProduct(productId);
     if (!product || quantity <= 0)
         return false;
 
@@ -34,7 +35,7 @@ bool ShoppingCart::addItem(Product* product, int quantity) {
 
     //if product already exists in cart
     for (auto& item : items) {
-        if (item.product->name == product->name) {
+        if (item.productId == productId) {
             if (product->stock < item.quantity + quantity) {    //checking availability in the stock
                 cout << "ERROR: Insufficient stock" << endl;
                 return false;
@@ -43,31 +44,27 @@ bool ShoppingCart::addItem(Product* product, int quantity) {
             item.quantity += quantity;
             cout << "SUCCESS: Updated " << product->name
                  << " quantity to " << item.quantity << endl;
-            saveToFile();
+            changed();
             return true;
         }
     }
 
     // Item not already in the cart, so add as new
-    items.push_back(CartItem(product, quantity));
+    items.push_back(CartItem(productId, quantity));
     cout << "SUCCESS: Added " << quantity << " x " << product->name << " to cart" << endl;
-    saveToFile();
+    changed();
     return true;
 }
 
 // Remove an entire product from the cart
 bool ShoppingCart::removeItem(const string& productName) {
-    string nameLower = productName;
-    transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
+    uint32_t id = catalog.findId(productName);
 
     for (auto it = items.begin(); it != items.end(); ++it) {
-        string itemNameLower = it->product->name;
-        transform(itemNameLower.begin(), itemNameLower.end(), itemNameLower.begin(), ::tolower);
-
-        if (itemNameLower == nameLower) {
-            cout << "SUCCESS: Removed " << it->product->name << " from cart" << endl;
+        if (it->productId == id) {
+            cout << "SUCCESS: Removed " << catalog.getProduct(id)->name << " from cart" << endl;
             items.erase(it);
-            saveToFile();
+            changed();
             return true;
         }
     }
@@ -85,10 +82,11 @@ void ShoppingCart::showCart() {
 
     cout << "CART_START" << endl;
     for (const auto& item : items) {
-        cout << item.product->name << "|"
+        const Product* p = catalog.getProduct(item.productId);
+        cout << p->name << "|"
              << item.quantity << "|"
-             << item.product->price << "|"
-             << (item.quantity * item.product->price) << endl;
+             << p->price << "|"
+             << (item.quantity * p->price) << endl;
     }
     cout << "CART_END" << endl;
     cout << "TOTAL: " << getTotal() << endl;    //final total amount print
@@ -97,7 +95,7 @@ void ShoppingCart::showCart() {
 double ShoppingCart::getTotal() {    //total price of cart
     double total = 0.0;
     for (const auto& item : items)
-        total += item.product->price * item.quantity;
+        total += catalog.getProduct(item.productId)->price * item.quantity;
     return total;
 }
 
@@ -110,20 +108,26 @@ void ShoppingCart::checkout(ProductManager& pm) {
 
     // Check stock availability before updating
     for (const auto& item : items) {
-        Product* p = pm.getProduct(item.product->name);
+        Product* p = pm.getProduct(item.productId);
         if (!p || p->stock < item.quantity) {
-            cout << "ERROR: Insufficient stock for " << item.product->name << endl;
+            cout << "ERROR: Insufficient stock for " << (p ? p->name : "unknown product") << endl;
             return;
         }
     }
 
     // Deduct stock quantities
+    vector<uint32_t> bought;
     for (const auto& item : items) {
-        pm.updateStock(item.product->name, item.quantity);
+        pm.updateStock(item.productId, -item.quantity);
+        bought.push_back(item.productId);
     }
 
-    
-    pm.saveProductsToFile("products.txt");
+    //append just these stock values, O(items) instead of rewriting the catalog
+    if (journal) {
+        if (!journal->append(bought)) cerr << "ERROR: Could not record stock change" << endl;
+    } else {
+        pm.saveProductsToFile("products.txt");
+    }
 
     double total = getTotal();
     cout << "CHECKOUT_SUCCESS" << endl;
@@ -137,25 +141,30 @@ void ShoppingCart::clear() {
     items.clear();
 }
 
-vector<CartItem> ShoppingCart::getItems() {
+const vector<CartItem>& ShoppingCart::getItems() const {
     return items;
 }
 
-// Load cart items from file
-void ShoppingCart::saveToFile() {
-    string filePath = getCartFilePath();
-    ofstream file(filePath);
-    if (!file.is_open()) {
-        cerr << "ERROR: Could not open " << filePath << " for writing" << endl;
-        return;
-    }
-        
-    // Write each item as: name|qty
-    for (auto& item : items) {
-        file << item.product->name << "|" << item.quantity << "\n";
+// Write each item as: name|qty
+string ShoppingCart::serialize() const {
+    string out;
+    for (const auto& item : items) {
+        out += catalog.getProduct(item.productId)->name;
+        out += '|';
+        out += to_string(item.quantity);
+        out += '\n';
     }
+    return out;
+}
 
-    file.close();
+//bursts of ADD/REMOVE end up as one background write unless every change must hit the disk
+void ShoppingCart::changed() {
+    if (durability == CART_WRITE_THROUGH) saveToFile();
+    else store.submit(getCartFilePath(), serialize());
+}
+
+void ShoppingCart::saveToFile() {
+    store.writeNow(getCartFilePath(), serialize());
 }
 
 void ShoppingCart::loadFromFile() {    // Load cart from file
@@ -172,10 +181,9 @@ void ShoppingCart::loadFromFile() {    // Load cart from file
         if (delim != string::npos) {
             string name = line.substr(0, delim);    //product name
             int qty = stoi(line.substr(delim + 1));    //quantity
-            extern ProductManager productManager;
-            Product* p = productManager.getProduct(name);     
-            if (p)
-                items.push_back(CartItem(p, qty));    //add to cart
+            uint32_t id = catalog.findId(name);
+            if (id != ProductManager::NO_ID)
+                items.push_back(CartItem(id, qty));    //add to cart
         }
     }
 
@@ -2,32 +2,44 @@
 #define CART_H
 
 #include "product.h"
+#include "stock_journal.h"
+#include "cart_store.h"
 #include <vector>
 #include <string>
 
 
 struct CartItem {
-    Product* product;    // Stores the product pointer + how many of that item
+    uint32_t productId;    // Stores the product id + how many of that item
     int quantity;    // Represents one item inside the cart
 
-    CartItem(Product* p, int q) : product(p), quantity(q) {}
+    CartItem(uint32_t id, int q) : productId(id), quantity(q) {}
 };
 
 //all cart operations (main class)
 class ShoppingCart {
 private:
+    ProductManager& catalog;    //resolves the ids in items
+    StockJournal* journal;    //records checkouts, without one the whole products.txt is rewritten
     std::vector<CartItem> items;
+    CartDurability durability = CART_BATCHED;
+    CartStore store;
+
+    std::string serialize() const;    //cart_data.txt contents
+    void changed();    //persist after a mutation, according to durability
 
 public:
-    bool addItem(Product* product, int quantity);
+    explicit ShoppingCart(ProductManager& pm, StockJournal* stockJournal = nullptr) : catalog(pm), journal(stockJournal) {}
+
+    bool addItem(uint32_t productId, int quantity);
     bool removeItem(const std::string& productName);    //add or remove from the cart
     void showCart();    //view complete cart items
     double getTotal();    //total cost of cart
     void checkout(ProductManager& pm);
     void clear();    //clear cart
-    std::vector<CartItem> getItems();
+    const std::vector<CartItem>& getItems() const;    //no copy, changes with the cart
 
-    void saveToFile();   // Save cart to file
+    void setDurability(CartDurability d) { durability = d; }
+    void saveToFile();   // Save cart to file now (checkout, exit), waits for the disk
     void loadFromFile(); // Load cart from file
 };
 
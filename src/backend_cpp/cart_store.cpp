@@ -0,0 +1,84 @@
+#include "cart_store.h"
+#include "mapped_file.h"
+#include <iostream>
+
+using namespace std;
+
+void CartStore::submit(const string& file, string contents) {
+    unique_lock<mutex> guard(lock);
+    if (stopping) {    //no worker any more, write it here
+        uint64_t version = nextVersion++;
+        guard.unlock();
+        write(file, contents, version, false);
+        return;
+    }
+    if (!worker.joinable()) worker = thread(&CartStore::run, this);    //started on first use
+
+    if (pendingVersion == 0) firstChange = chrono::steady_clock::now();
+    path = file;
+    pending = move(contents);
+    pendingVersion = nextVersion++;
+    changes++;
+    if (changes >= CART_FLUSH_CHANGES) wake.notify_one();
+}
+
+bool CartStore::writeNow(const string& file, const string& contents) {
+    uint64_t version;
+    {
+        unique_lock<mutex> guard(lock);
+        version = nextVersion++;
+        pending.clear();
+        pendingVersion = 0;    //superseded
+        changes = 0;
+    }
+    return write(file, contents, version, true);
+}
+
+//drops the write if a newer version already reached the file
+bool CartStore::write(const string& file, const string& contents, uint64_t version, bool sync) {
+    lock_guard<mutex> guard(fileLock);
+    if (version < writtenVersion) return true;
+    if (!replaceFile(file, contents, sync)) {
+        cerr << "ERROR: Could not open " << file << " for writing" << endl;
+        return false;
+    }
+    writtenVersion = version;
+    return true;
+}
+
+void CartStore::run() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        if (pendingVersion == 0) {
+            if (stopping) return;
+            wake.wait(guard);
+            continue;
+        }
+
+        //wait out the delay unless enough changes piled up or we are shutting down
+        auto due = firstChange + chrono::milliseconds(CART_FLUSH_DELAY_MS);
+        if (!stopping && changes < CART_FLUSH_CHANGES && chrono::steady_clock::now() < due) {
+            wake.wait_until(guard, due);
+            continue;
+        }
+
+        string file = path, contents;
+        contents.swap(pending);
+        uint64_t version = pendingVersion;
+        pendingVersion = 0;
+        changes = 0;
+
+        guard.unlock();
+        write(file, contents, version, false);
+        guard.lock();
+    }
+}
+
+void CartStore::stop() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) worker.join();
+}
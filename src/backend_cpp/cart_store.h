@@ -0,0 +1,56 @@
+#ifndef CART_STORE_H
+#define CART_STORE_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+//how cart changes reach cart_data.txt
+enum CartDurability {
+    CART_BATCHED,          //coalesced and written in the background; checkout and exit write at once
+    CART_WRITE_THROUGH     //every change is written and fsynced before the command answers
+};
+
+//a batched write happens this long after the first unsaved change...
+const int CART_FLUSH_DELAY_MS = 200;
+//...or as soon as this many changes are waiting
+const int CART_FLUSH_CHANGES = 16;
+
+//background writer for the cart file. submit() only swaps in the newest contents, so a burst
+//of changes costs one write. every write is temp file + rename
+class CartStore {
+private:
+    mutex lock;    //guards everything below except worker
+    condition_variable wake;
+    thread worker;
+    bool stopping = false;
+
+    string path;
+    string pending;    //newest unsaved contents
+    uint64_t pendingVersion = 0;    //0 = nothing pending
+    uint64_t nextVersion = 1;
+    int changes = 0;    //submits since the last write
+    chrono::steady_clock::time_point firstChange;
+
+    mutex fileLock;    //one write at a time, in version order
+    uint64_t writtenVersion = 0;
+
+    void run();
+    bool write(const string& file, const string& contents, uint64_t version, bool sync);
+
+public:
+    CartStore() {}
+    ~CartStore() { stop(); }
+    CartStore(const CartStore&) = delete;
+    CartStore& operator=(const CartStore&) = delete;
+
+    void submit(const string& file, string contents);    //write later, replaces anything pending
+    bool writeNow(const string& file, const string& contents);    //synchronous and fsynced, drops pending
+    void stop();    //write whatever is pending and end the worker
+};
+
+#endif
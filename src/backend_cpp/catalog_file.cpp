@@ -0,0 +1,121 @@
+#include "catalog_file.h"
+#include "mapped_file.h"
+#include <cstring>
+#include <cstdio>
+
+using namespace std;
+
+static const char CATALOG_MAGIC[8] = {'E', 'C', 'C', 'A', 'T', 'L', 'G', '1'};
+static const uint32_t CATALOG_VERSION = 1;    //bump whenever the layout changes
+
+static inline size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+//byte offsets of every section, shared by the writer and the reader
+struct CatalogLayout {
+    size_t price, stock, category, brand, offsets, heap, total;
+
+    CatalogLayout(uint64_t n, uint64_t c, uint64_t b, uint64_t heapBytes) {
+        price = sizeof(CatalogFileHeader);
+        stock = align8(price + n * sizeof(double));
+        category = align8(stock + n * sizeof(int32_t));
+        brand = align8(category + n * sizeof(uint32_t));
+        offsets = align8(brand + n * sizeof(uint32_t));
+        heap = offsets + (c + b + n + 1) * sizeof(uint64_t);
+        total = align8(heap + heapBytes);
+    }
+};
+
+bool isCatalogFile(const char* data, size_t size) {
+    return size >= sizeof(CATALOG_MAGIC) && memcmp(data, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) == 0;
+}
+
+//word-at-a-time multiply/rotate hash, several GB/s so verifying never dominates a load
+uint64_t catalogChecksum(const char* data, size_t size) {
+    const uint64_t K = 0x9E3779B97F4A7C15ull;
+    uint64_t h = size * K;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = ((h << 31) | (h >> 33)) ^ w;
+        h *= K;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    h = (((h << 31) | (h >> 33)) ^ tail) * K;
+    return h ^ (h >> 29);
+}
+
+void CatalogFileWriter::addString(int kind, string_view s) {
+    heap[kind].append(s.data(), s.size());
+    ends[kind].push_back(heap[kind].size());
+}
+
+void CatalogFileWriter::addProduct(string_view name, double p, int32_t s, uint32_t category, uint32_t brand) {
+    addString(2, name);
+    price.push_back(p);
+    stock.push_back(s);
+    categoryId.push_back(category);
+    brandId.push_back(brand);
+}
+
+string CatalogFileWriter::serialize() const {
+    CatalogFileHeader h{};
+    memcpy(h.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+    h.version = CATALOG_VERSION;
+    h.products = static_cast<uint32_t>(price.size());
+    h.categories = static_cast<uint32_t>(ends[0].size());
+    h.brands = static_cast<uint32_t>(ends[1].size());
+    h.heapBytes = heap[0].size() + heap[1].size() + heap[2].size();
+
+    CatalogLayout at(h.products, h.categories, h.brands, h.heapBytes);
+    string buf(at.total, '\0');
+    char* out = &buf[0];
+    memcpy(out + at.price, price.data(), price.size() * sizeof(double));
+    memcpy(out + at.stock, stock.data(), stock.size() * sizeof(int32_t));
+    memcpy(out + at.category, categoryId.data(), categoryId.size() * sizeof(uint32_t));
+    memcpy(out + at.brand, brandId.data(), brandId.size() * sizeof(uint32_t));
+
+    //one offset table over the three heaps laid end to end
+    uint64_t* offs = reinterpret_cast<uint64_t*>(out + at.offsets);
+    size_t k = 0;
+    uint64_t base = 0;
+    offs[k++] = 0;
+    for (int kind = 0; kind < 3; kind++) {
+        for (uint64_t e : ends[kind]) offs[k++] = base + e;
+        memcpy(out + at.heap + base, heap[kind].data(), heap[kind].size());
+        base += heap[kind].size();
+    }
+
+    h.checksum = catalogChecksum(out + sizeof(h), at.total - sizeof(h));
+    memcpy(out, &h, sizeof(h));
+    return buf;
+}
+
+bool CatalogFileWriter::save(const string& filename, bool sync) const {
+    return replaceFile(filename, serialize(), sync);
+}
+
+bool CatalogFileReader::open(const char* data, size_t size) {
+    if (!isCatalogFile(data, size) || size < sizeof(CatalogFileHeader)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != CATALOG_VERSION || header.heapBytes > size) return false;
+
+    CatalogLayout at(header.products, header.categories, header.brands, header.heapBytes);
+    if (at.total != size) return false;    //truncated or trailing garbage
+    if (catalogChecksum(data + sizeof(header), size - sizeof(header)) != header.checksum) return false;
+
+    priceCol = reinterpret_cast<const double*>(data + at.price);
+    stockCol = reinterpret_cast<const int32_t*>(data + at.stock);
+    categoryCol = reinterpret_cast<const uint32_t*>(data + at.category);
+    brandCol = reinterpret_cast<const uint32_t*>(data + at.brand);
+    offsets = reinterpret_cast<const uint64_t*>(data + at.offsets);
+    heap = data + at.heap;
+
+    //offsets must climb from 0 to the heap size, or text() could read outside the file
+    size_t strings = size_t(header.categories) + header.brands + header.products;
+    if (offsets[0] != 0 || offsets[strings] != header.heapBytes) return false;
+    for (size_t i = 0; i < strings; i++)
+        if (offsets[i] > offsets[i + 1]) return false;
+    return true;
+}
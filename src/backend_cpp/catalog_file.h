@@ -0,0 +1,79 @@
+#ifndef CATALOG_FILE_H
+#define CATALOG_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+//binary columnar catalog (products.cat), the compact alternative to products.txt:
+//  header | price f64[n] | stock i32[n] | categoryId u32[n] | brandId u32[n]
+//         | string offsets u64[c + b + n + 1] | string heap (category names, brand names, product names)
+//every section starts on an 8-byte boundary, so a mapped file is read in place
+struct CatalogFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t products;
+    uint32_t categories;
+    uint32_t brands;
+    uint64_t heapBytes;
+    uint64_t checksum;    //of everything after the header
+};
+
+bool isCatalogFile(const char* data, size_t size);    //magic check only
+uint64_t catalogChecksum(const char* data, size_t size);
+
+//collects columns and names, then writes the file in one go
+class CatalogFileWriter {
+private:
+    vector<double> price;
+    vector<int32_t> stock;
+    vector<uint32_t> categoryId;
+    vector<uint32_t> brandId;
+    string heap[3];    //categories, brands, product names
+    vector<uint64_t> ends[3];    //end offset of each string inside its heap
+
+    void addString(int kind, string_view s);
+
+public:
+    void addCategory(string_view name) { addString(0, name); }    //ids are given in call order
+    void addBrand(string_view name) { addString(1, name); }
+    void addProduct(string_view name, double p, int32_t s, uint32_t category, uint32_t brand);
+
+    string serialize() const;    //the whole file, header and checksum included
+    bool save(const string& filename, bool sync = false) const;    //replaceFile(), false on I/O errors
+};
+
+//validated read-only view of a mapped catalog file
+class CatalogFileReader {
+private:
+    CatalogFileHeader header{};
+    const double* priceCol = nullptr;
+    const int32_t* stockCol = nullptr;
+    const uint32_t* categoryCol = nullptr;
+    const uint32_t* brandCol = nullptr;
+    const uint64_t* offsets = nullptr;
+    const char* heap = nullptr;
+
+    string_view text(size_t i) const { return string_view(heap + offsets[i], offsets[i + 1] - offsets[i]); }
+
+public:
+    //checks magic, version, section sizes, checksum and string offsets; data must be 8-byte aligned
+    bool open(const char* data, size_t size);
+
+    uint32_t productCount() const { return header.products; }
+    uint32_t categoryCount() const { return header.categories; }
+    uint32_t brandCount() const { return header.brands; }
+
+    double price(uint32_t i) const { return priceCol[i]; }
+    int32_t stock(uint32_t i) const { return stockCol[i]; }
+    uint32_t categoryId(uint32_t i) const { return categoryCol[i]; }    //not range checked
+    uint32_t brandId(uint32_t i) const { return brandCol[i]; }
+    string_view name(uint32_t i) const { return text(header.categories + header.brands + i); }
+    string_view categoryName(uint32_t id) const { return text(id); }
+    string_view brandName(uint32_t id) const { return text(header.categories + id); }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "catalog_parser.h"
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+static inline string_view trimView(string_view s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == string_view::npos) return s.substr(s.size());    //empty, but still points into the line
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+
+//from_chars does not take a leading '+', stod did
+static inline string_view skipPlus(string_view s) {
+    if (!s.empty() && s[0] == '+') s.remove_prefix(1);
+    return s;
+}
+
+//leading number of the field like stod/stoi, 0 when there is none or it overflows
+static double toPrice(string_view s) {
+    s = skipPlus(s);
+    double v = 0.0;
+    if (from_chars(s.data(), s.data() + s.size(), v).ec != errc()) return 0.0;
+    return v;
+}
+
+static int toStock(string_view s) {
+    s = skipPlus(s);
+    int v = 0;
+    if (from_chars(s.data(), s.data() + s.size(), v).ec != errc()) return 0;
+    return v;
+}
+
+bool parseCatalogLine(string_view line, CatalogRow& row) {
+    if (line.empty()) return false;    //skip blanks
+    if (line[0] == '#') return false;    //skip comments
+
+    string_view parts[5];
+    size_t n = 0, pos = 0;
+    while (true) {
+        const char* bar = static_cast<const char*>(memchr(line.data() + pos, '|', line.size() - pos));
+        size_t end = bar ? static_cast<size_t>(bar - line.data()) : line.size();
+        if (n < 5) parts[n] = trimView(line.substr(pos, end - pos));
+        n++;
+        if (!bar) break;
+        pos = end + 1;
+        if (pos == line.size()) break;    //a trailing '|' does not open an empty field
+    }
+    if (n < 4) return false;
+
+    row.name = parts[0];
+    row.price = toPrice(parts[1]);
+    row.stock = toStock(parts[2]);
+    row.stockText = parts[2];
+    row.category = parts[3];
+    row.brand = parts[4];
+    return true;
+}
+
+//parse the lines in [first, last), last is just after a '\n' or the end of the buffer
+static void parseRange(const char* first, const char* last, vector<CatalogRow>& out) {
+    CatalogRow row;
+    while (first < last) {
+        const char* nl = static_cast<const char*>(memchr(first, '\n', last - first));
+        const char* end = nl ? nl : last;
+        if (parseCatalogLine(string_view(first, end - first), row)) out.push_back(row);
+        first = end + 1;
+    }
+}
+
+vector<CatalogRow> parseCatalog(const char* data, size_t size, unsigned threads) {
+    if (threads == 0) {
+        size_t cores = max(1u, thread::hardware_concurrency());
+        threads = static_cast<unsigned>(max<size_t>(1, min(cores, size / PARALLEL_PARSE_BYTES)));
+    }
+
+    vector<CatalogRow> rows;
+    if (threads <= 1) {
+        parseRange(data, data + size, rows);
+        return rows;
+    }
+
+    //cut at line starts near equal byte offsets, chunk i is [cut[i], cut[i + 1])
+    const char* last = data + size;
+    vector<const char*> cut(threads + 1, last);
+    cut[0] = data;
+    for (unsigned i = 1; i < threads; i++) {
+        const char* at = max(cut[i - 1], data + size / threads * i);
+        const char* nl = static_cast<const char*>(memchr(at, '\n', last - at));
+        cut[i] = nl ? nl + 1 : last;
+    }
+
+    vector<vector<CatalogRow>> parts(threads);
+    vector<thread> workers;
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(parseRange, cut[i], cut[i + 1], ref(parts[i]));
+    parseRange(cut[0], cut[1], parts[0]);
+    for (thread &t : workers) t.join();
+
+    size_t total = 0;
+    for (const auto &p : parts) total += p.size();
+    rows = move(parts[0]);
+    rows.reserve(total);
+    for (unsigned i = 1; i < threads; i++) rows.insert(rows.end(), parts[i].begin(), parts[i].end());
+    return rows;
+}
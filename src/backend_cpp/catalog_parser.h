@@ -0,0 +1,29 @@
+#ifndef CATALOG_PARSER_H
+#define CATALOG_PARSER_H
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+//one products.txt line split in place: the views point into the parsed buffer
+struct CatalogRow {
+    string_view name;
+    double price = 0.0;    //0 when the field is not a number
+    int stock = 0;
+    string_view stockText;    //the trimmed stock field, lets a rewrite replace just that span
+    string_view category;
+    string_view brand;
+};
+
+//below this many bytes per thread the file is parsed on one thread
+const size_t PARALLEL_PARSE_BYTES = 4 << 20;
+
+//split one line (no '\n') into trimmed fields, false for blanks, '#' comments and lines with < 4 fields
+bool parseCatalogLine(string_view line, CatalogRow& row);
+
+//parse a whole Name|Price|Stock|Category|Brand buffer, rows in file order.
+//threads = 0 picks one thread per PARALLEL_PARSE_BYTES up to the core count, 1 forces a single pass
+vector<CatalogRow> parseCatalog(const char* data, size_t size, unsigned threads = 0);
+
+#endif
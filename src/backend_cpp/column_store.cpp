@@ -0,0 +1,308 @@
+#include "column_store.h"
+#include "product.h"
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <limits>
+
+//widest vector unit the compiler was allowed to use, scalar loops otherwise
+#if defined(__AVX2__)
+#define COLUMN_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLUMN_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+static const size_t BLOCK_ROWS = 64;
+
+//index of the lowest set bit, w must not be 0
+static inline unsigned lowestBit(uint64_t w) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return i;
+#elif defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    unsigned i = 0;
+    while (!((w >> i) & 1)) i++;
+    return i;
+#endif
+}
+
+static inline size_t popCount(uint64_t w) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    size_t n = 0;
+    for (; w; w &= w - 1) n++;
+    return n;
+#endif
+}
+
+size_t SelectionBitmap::count() const {
+    size_t n = 0;
+    for (uint64_t w : words) n += popCount(w);
+    return n;
+}
+
+void ProductColumns::clear() {
+    rows.clear();
+    price.clear();
+    categoryId.clear();
+    brandId.clear();
+    categoryRows.clear();
+    brandRows.clear();
+    priceRows.clear();
+    sortedPrice.clear();
+    categories = nullptr;
+    brands = nullptr;
+}
+
+void ProductColumns::build(const vector<const Product*>& catalog, const NameDictionary& categoryNames,
+                           const NameDictionary& brandNames) {
+    clear();
+    rows = catalog;
+    categories = &categoryNames;
+    brands = &brandNames;
+
+    size_t padded = (rows.size() + BLOCK_ROWS - 1) / BLOCK_ROWS * BLOCK_ROWS;
+    price.assign(padded, numeric_limits<double>::quiet_NaN());
+    categoryId.assign(padded, NO_ID);
+    brandId.assign(padded, NO_ID);
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Product *p = rows[i];
+        price[i] = p->price;
+        categoryId[i] = p->categoryId;
+        brandId[i] = p->brandId;
+    }
+
+    //rows are visited in order, so every posting list comes out sorted
+    categoryRows.assign(categoryNames.size(), vector<uint32_t>());
+    brandRows.assign(brandNames.size(), vector<uint32_t>());
+    for (uint32_t i = 0; i < rows.size(); i++) {
+        if (categoryId[i] < categoryRows.size()) categoryRows[categoryId[i]].push_back(i);
+        if (brandId[i] < brandRows.size()) brandRows[brandId[i]].push_back(i);
+    }
+
+    //prices only change on reload, so a sorted array is enough
+    priceRows.resize(rows.size());
+    for (uint32_t i = 0; i < rows.size(); i++) priceRows[i] = i;
+    stable_sort(priceRows.begin(), priceRows.end(), [&](uint32_t a, uint32_t b) { return price[a] < price[b]; });
+    sortedPrice.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) sortedPrice[i] = price[priceRows[i]];
+}
+
+//each pass below turns one 64-row block into a 64-bit match mask
+
+//lo <= price <= hi
+static uint64_t priceBlock(const double* v, double lo, double hi) {
+    uint64_t mask = 0;
+#if defined(COLUMN_SIMD_AVX2)
+    __m256d vlo = _mm256_set1_pd(lo), vhi = _mm256_set1_pd(hi);
+    for (size_t i = 0; i < BLOCK_ROWS; i += 4) {
+        __m256d x = _mm256_loadu_pd(v + i);
+        __m256d in = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LE_OQ));
+        mask |= uint64_t(_mm256_movemask_pd(in)) << i;
+    }
+#elif defined(COLUMN_SIMD_SSE2)
+    __m128d vlo = _mm_set1_pd(lo), vhi = _mm_set1_pd(hi);
+    for (size_t i = 0; i < BLOCK_ROWS; i += 2) {
+        __m128d x = _mm_loadu_pd(v + i);
+        __m128d in = _mm_and_pd(_mm_cmpge_pd(x, vlo), _mm_cmple_pd(x, vhi));
+        mask |= uint64_t(_mm_movemask_pd(in)) << i;
+    }
+#else
+    for (size_t i = 0; i < BLOCK_ROWS; i++) {
+        if (v[i] >= lo && v[i] <= hi) mask |= uint64_t(1) << i;
+    }
+#endif
+    return mask;
+}
+
+//value == id
+static uint64_t equalBlock(const uint32_t* v, uint32_t id) {
+    uint64_t mask = 0;
+#if defined(COLUMN_SIMD_AVX2)
+    __m256i vid = _mm256_set1_epi32(int32_t(id));
+    for (size_t i = 0; i < BLOCK_ROWS; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        __m256i eq = _mm256_cmpeq_epi32(x, vid);
+        mask |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) << i;
+    }
+#elif defined(COLUMN_SIMD_SSE2)
+    __m128i vid = _mm_set1_epi32(int32_t(id));
+    for (size_t i = 0; i < BLOCK_ROWS; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+        __m128i eq = _mm_cmpeq_epi32(x, vid);
+        mask |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(eq))) << i;
+    }
+#else
+    for (size_t i = 0; i < BLOCK_ROWS; i++) {
+        if (v[i] == id) mask |= uint64_t(1) << i;
+    }
+#endif
+    return mask;
+}
+
+bool ProductColumns::resolve(const ProductFilters& f, Query& q) const {
+    q.byPrice = f.min_price >= 0.0 || f.max_price >= 0.0;
+    q.lo = f.min_price >= 0.0 ? f.min_price : -numeric_limits<double>::infinity();
+    q.hi = f.max_price >= 0.0 ? f.max_price : numeric_limits<double>::infinity();
+
+    if (!f.category.empty()) {
+        q.category = categories ? categories->find(f.category) : NO_ID;
+        if (q.category == NO_ID) return false;
+    }
+
+    for (const string &b : f.brands) {
+        uint32_t id = brands ? brands->find(b) : NO_ID;
+        if (id != NO_ID) q.brands.push_back(id);
+    }
+    return f.brands.empty() || !q.brands.empty();
+}
+
+SelectionBitmap ProductColumns::scan(const Query& q) const {
+    SelectionBitmap sel;
+    sel.rows = rows.size();
+    size_t blocks = price.size() / BLOCK_ROWS;
+
+    //block at a time so the mask stays in a register across all passes
+    sel.words.resize(blocks);
+    for (size_t b = 0; b < blocks; b++) {
+        size_t base = b * BLOCK_ROWS;
+        size_t live = min(BLOCK_ROWS, rows.size() - base);
+        uint64_t mask = live == BLOCK_ROWS ? ~uint64_t(0) : (uint64_t(1) << live) - 1;
+
+        if (mask && q.byPrice) mask &= priceBlock(price.data() + base, q.lo, q.hi);
+        if (mask && q.category != NO_ID) mask &= equalBlock(categoryId.data() + base, q.category);
+        if (mask && !q.brands.empty()) {
+            uint64_t any = 0;
+            for (uint32_t id : q.brands) any |= equalBlock(brandId.data() + base, id);
+            mask &= any;
+        }
+        sel.words[b] = mask;
+    }
+    return sel;
+}
+
+SelectionBitmap ProductColumns::select(const ProductFilters& f) const {
+    Query q;
+    if (!resolve(f, q)) {
+        SelectionBitmap none;
+        none.rows = rows.size();
+        none.words.assign(price.size() / BLOCK_ROWS, 0);
+        return none;
+    }
+    return scan(q);
+}
+
+const vector<uint32_t>& ProductColumns::rowsInCategory(uint32_t id) const {
+    static const vector<uint32_t> none;
+    return id < categoryRows.size() ? categoryRows[id] : none;
+}
+
+const vector<uint32_t>& ProductColumns::rowsOfBrand(uint32_t id) const {
+    static const vector<uint32_t> none;
+    return id < brandRows.size() ? brandRows[id] : none;
+}
+
+//union of the brand lists, intersected with the category list
+vector<uint32_t> ProductColumns::postingRows(const Query& q) const {
+    vector<uint32_t> out, merged;
+    if (!q.brands.empty()) {
+        out = rowsOfBrand(q.brands[0]);
+        for (size_t i = 1; i < q.brands.size(); i++) {
+            const vector<uint32_t>& more = rowsOfBrand(q.brands[i]);
+            merged.clear();
+            set_union(out.begin(), out.end(), more.begin(), more.end(), back_inserter(merged));
+            out.swap(merged);
+        }
+        if (q.category != NO_ID) {
+            const vector<uint32_t>& cat = rowsInCategory(q.category);
+            merged.clear();
+            set_intersection(out.begin(), out.end(), cat.begin(), cat.end(), back_inserter(merged));
+            out.swap(merged);
+        }
+    } else if (q.category != NO_ID) {
+        out = rowsInCategory(q.category);
+    }
+    return out;
+}
+
+bool ProductColumns::rowMatches(uint32_t row, const Query& q) const {
+    if (q.byPrice && !(price[row] >= q.lo && price[row] <= q.hi)) return false;
+    if (q.category != NO_ID && categoryId[row] != q.category) return false;
+    if (!q.brands.empty() && find(q.brands.begin(), q.brands.end(), brandId[row]) == q.brands.end()) return false;
+    return true;
+}
+
+size_t ProductColumns::countInPriceRange(double lo, double hi) const {
+    if (!(lo <= hi)) return 0;
+    auto first = lower_bound(sortedPrice.begin(), sortedPrice.end(), lo);
+    auto last = upper_bound(first, sortedPrice.end(), hi);
+    return last - first;
+}
+
+//an index drives the query only when it leaves fewer rows to check than this fraction of the catalog
+static const size_t INDEX_SCAN_RATIO = 8;
+
+vector<const Product*> ProductColumns::filter(const ProductFilters& f) const {
+    vector<const Product*> out;
+    Query q;
+    if (!resolve(f, q)) return out;
+
+    //upper bound on the rows the posting lists would produce
+    size_t postingEstimate = SIZE_MAX;
+    if (q.category != NO_ID) postingEstimate = rowsInCategory(q.category).size();
+    if (!q.brands.empty()) {
+        size_t brandRowCount = 0;
+        for (uint32_t id : q.brands) brandRowCount += rowsOfBrand(id).size();
+        postingEstimate = min(postingEstimate, brandRowCount);
+    }
+
+    //exact size of the price range, two binary searches
+    size_t priceFirst = 0, priceCount = SIZE_MAX;
+    if (q.byPrice) {
+        priceFirst = lower_bound(sortedPrice.begin(), sortedPrice.end(), q.lo) - sortedPrice.begin();
+        priceCount = countInPriceRange(q.lo, q.hi);
+    }
+
+    size_t best = min(postingEstimate, priceCount);
+    if (best == SIZE_MAX || best * INDEX_SCAN_RATIO > rows.size()) {
+        //nothing selective enough, vector scan over the columns
+        SelectionBitmap sel = scan(q);
+        out.reserve(sel.count());
+        for (size_t b = 0; b < sel.words.size(); b++) {
+            for (uint64_t w = sel.words[b]; w; w &= w - 1) {
+                out.push_back(rows[b * BLOCK_ROWS + lowestBit(w)]);
+            }
+        }
+        return out;
+    }
+
+    if (postingEstimate <= priceCount) {
+        for (uint32_t row : postingRows(q)) {
+            if (rowMatches(row, q)) out.push_back(rows[row]);
+        }
+        return out;
+    }
+
+    //price band drives: check the rest on its rows, then back to catalog order
+    vector<uint32_t> hits;
+    for (size_t i = priceFirst; i < priceFirst + priceCount; i++) {
+        if (rowMatches(priceRows[i], q)) hits.push_back(priceRows[i]);
+    }
+    sort(hits.begin(), hits.end());
+    out.reserve(hits.size());
+    for (uint32_t row : hits) out.push_back(rows[row]);
+    return out;
+}
@@ -0,0 +1,75 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "name_dictionary.h"
+using namespace std;
+
+struct Product;
+struct ProductFilters;
+
+//one bit per row: row i is bit (i % 64) of words[i / 64]
+struct SelectionBitmap {
+    vector<uint64_t> words;
+    size_t rows = 0;
+
+    size_t count() const;    //number of selected rows
+};
+
+//structure-of-arrays copy of the fields used by filters, one row per product in catalog order.
+//columns are padded to whole 64-row blocks so the predicate passes never need a scalar tail
+class ProductColumns {
+private:
+    vector<const Product*> rows;    //row -> product
+    vector<double> price;    //padding rows hold NaN, which fails every comparison
+    vector<uint32_t> categoryId;    //ids from the product manager's dictionaries
+    vector<uint32_t> brandId;
+
+    const NameDictionary* categories = nullptr;
+    const NameDictionary* brands = nullptr;
+
+    //posting lists: id -> rows with that category / brand, ascending
+    vector<vector<uint32_t>> categoryRows;
+    vector<vector<uint32_t>> brandRows;
+
+    //price index: rows ordered by price (ties by row) and their prices, for binary search
+    vector<uint32_t> priceRows;
+    vector<double> sortedPrice;
+
+    //ProductFilters with names resolved to ids and open price bounds made infinite
+    struct Query {
+        bool byPrice = false;
+        double lo = 0.0, hi = 0.0;
+        uint32_t category = NameDictionary::NO_ID;
+        vector<uint32_t> brands;
+    };
+    bool resolve(const ProductFilters& f, Query& q) const;    //false when nothing can match
+    SelectionBitmap scan(const Query& q) const;
+    vector<uint32_t> postingRows(const Query& q) const;    //rows passing the category and brand filters
+    bool rowMatches(uint32_t row, const Query& q) const;    //scalar check of every filter
+
+public:
+    static constexpr uint32_t NO_ID = NameDictionary::NO_ID;
+
+    //products and dictionaries must outlive the columns
+    void build(const vector<const Product*>& catalog, const NameDictionary& categoryNames,
+               const NameDictionary& brandNames);
+    void clear();
+
+    size_t size() const { return rows.size(); }
+    const Product* product(uint32_t row) const { return rows[row]; }
+    const vector<uint32_t>& rowsInCategory(uint32_t id) const;    //empty for unknown ids
+    const vector<uint32_t>& rowsOfBrand(uint32_t id) const;
+
+    SelectionBitmap select(const ProductFilters& f) const;    //rows passing every filter, full column scan
+    //same, as products in catalog order. the most selective of the price range and the
+    //category/brand postings drives the scan when it is small enough, else the columns are scanned
+    vector<const Product*> filter(const ProductFilters& f) const;
+
+    size_t countInPriceRange(double lo, double hi) const;    //products with lo <= price <= hi, O(log n)
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "edit_distance.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+//bit-parallel global edit distance (Myers 1999, Hyyro's formulation), |pattern| <= 64
+static int myersDistance(string_view pattern, string_view text, int maxDistance) {
+    //per-thread match table, kept all zero between calls so setup is O(|pattern|)
+    static thread_local uint64_t peq[256];
+
+    const int m = pattern.size();
+    const int n = text.size();
+    for (int i = 0; i < m; i++) peq[(uint8_t)pattern[i]] |= (1ULL << i);
+
+    const uint64_t last = 1ULL << (m - 1);
+    uint64_t pv = (m == 64) ? ~0ULL : ((1ULL << m) - 1);
+    uint64_t mv = 0;
+    int score = m;
+    int result = -1;
+
+    for (int j = 0; j < n; j++) {
+        uint64_t eq = peq[(uint8_t)text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last) score++;
+        else if (mh & last) score--;
+
+        //row 0 grows by one per column in the global distance
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        //each remaining column can lower the score by at most one
+        if (score - (n - j - 1) > maxDistance) {
+            result = maxDistance + 1;
+            break;
+        }
+    }
+
+    for (int i = 0; i < m; i++) peq[(uint8_t)pattern[i]] = 0;
+
+    if (result >= 0) return result;
+    return score <= maxDistance ? score : maxDistance + 1;
+}
+
+//Ukkonen style banded DP, only diagonals -k..k of the matrix are evaluated
+static int bandedDistance(string_view a, string_view b, int k) {
+    const int INF = INT_MAX / 2;
+    const int n = a.size();
+    const int m = b.size();
+    const int width = 2 * k + 1;
+
+    //cell (i, j) lives at index j - i + k of its row
+    int rows[2][2 * kMaxBandedDistance + 1];
+    int *prev = rows[0];
+    int *cur = rows[1];
+
+    for (int d = 0; d < width; d++) {
+        int j = d - k;
+        prev[d] = (j >= 0 && j <= m) ? j : INF;
+    }
+
+    for (int i = 1; i <= n; i++) {
+        int rowMin = INF;
+        for (int d = 0; d < width; d++) {
+            int j = i + d - k;
+            if (j < 0 || j > m) {
+                cur[d] = INF;
+                continue;
+            }
+            if (j == 0) {
+                cur[d] = i;
+            } else {
+                int best = prev[d] + (a[i - 1] != b[j - 1] ? 1 : 0);    //diagonal
+                if (d + 1 < width) best = min(best, prev[d + 1] + 1);    //from the row above
+                if (d > 0) best = min(best, cur[d - 1] + 1);    //from the left
+                cur[d] = best;
+            }
+            rowMin = min(rowMin, cur[d]);
+        }
+        if (rowMin > k) return k + 1;    //every path already costs more than k
+        swap(prev, cur);
+    }
+
+    int result = prev[m - n + k];
+    return result <= k ? result : k + 1;
+}
+
+//plain two-row DP over the whole matrix, for bounds wider than the band. the row is a
+//per-thread buffer, so only the first call with a new longest input allocates
+static int fullDistance(string_view a, string_view b, int k) {
+    static thread_local vector<int> row;
+    const int n = a.size();    //a is the shorter one
+    row.resize(n + 1);
+    for (int i = 0; i <= n; i++) row[i] = i;
+
+    for (size_t j = 1; j <= b.size(); j++) {
+        int diag = row[0];
+        row[0] = j;
+        int rowMin = row[0];
+        for (int i = 1; i <= n; i++) {
+            int up = row[i];
+            row[i] = min(min(up, row[i - 1]) + 1, diag + (a[i - 1] != b[j - 1] ? 1 : 0));
+            diag = up;
+            rowMin = min(rowMin, row[i]);
+        }
+        if (rowMin > k) return k + 1;
+    }
+    return row[n] <= k ? row[n] : k + 1;
+}
+
+int editDistance(string_view a, string_view b, int maxDistance) {
+    if (maxDistance < 0) return maxDistance + 1;    //nothing is within a negative bound
+    const int tooFar = maxDistance == INT_MAX ? INT_MAX : maxDistance + 1;
+
+    //the distance never exceeds the longer length, so tighten the bound first
+    int longest = max(a.size(), b.size());
+    int k = min(maxDistance, longest);
+
+    int lengthGap = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+    if (lengthGap > k) return tooFar;
+
+    if (a.size() > b.size()) swap(a, b);    //a is the shorter one from here on
+    if (a.empty()) return b.size();
+
+    if (a.size() <= 64) {
+        int d = myersDistance(a, b, k);
+        return d <= k ? d : tooFar;
+    }
+
+    //the band lives on the stack, wider bounds take the full matrix instead of being clamped
+    int d = k <= kMaxBandedDistance ? bandedDistance(a, b, k) : fullDistance(a, b, k);
+    return d <= k ? d : tooFar;
+}
@@ -0,0 +1,19 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <string_view>
+#include <climits>
+using namespace std;
+
+//widest bound the banded path keeps on the stack, wider ones run the full DP
+const int kMaxBandedDistance = 511;
+
+//Levenshtein distance between a and b without heap allocations (the full DP reuses one row per thread).
+//returns the exact distance when it is <= maxDistance, otherwise maxDistance + 1
+//(so callers that only need "dist <= k" can stop early).
+//inputs whose shorter side fits in 64 chars use the bit-parallel Myers/Hyyro kernel,
+//longer ones use a banded DP that only fills the 2*maxDistance+1 diagonals, or the
+//full DP when the bound (after capping it at the longer length) is above kMaxBandedDistance
+int editDistance(string_view a, string_view b, int maxDistance = INT_MAX);
+
+#endif
@@ -0,0 +1,156 @@
+#include "fuzzy_index.h"
+#include "text_normalize.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+//the n bytes (1 to 3) at s[i], with n in the top byte so grams of different lengths never collide
+static inline uint32_t gramKey(const string& s, size_t i, size_t n) {
+    uint32_t key = uint32_t(n) << 24;
+    for (size_t j = 0; j < n; j++) key |= uint32_t(uint8_t(s[i + j])) << (8 * (n - 1 - j));
+    return key;
+}
+
+void FuzzySearchIndex::build(const vector<const Product*>& products) {
+    docs = products;
+    docNames.clear();
+    bkNodes.clear();
+    wordNode.clear();
+    gramPostings.clear();
+
+    for (uint32_t doc = 0; doc < docs.size(); doc++) {
+        string name = foldKey(docs[doc]->name);
+
+        //split into whitespace separated words
+        size_t i = 0;
+        while (i < name.size()) {
+            while (i < name.size() && isspace((unsigned char)name[i])) i++;
+            size_t start = i;
+            while (i < name.size() && !isspace((unsigned char)name[i])) i++;
+            if (i > start) addWord(name.substr(start, i - start), doc);
+        }
+
+        //doc ids grow, so every posting list stays sorted
+        for (size_t n = 1; n <= 3; n++)
+            for (size_t j = 0; j + n <= name.size(); j++) {
+                vector<uint32_t> &list = gramPostings[gramKey(name, j, n)];
+                if (list.empty() || list.back() != doc) list.push_back(doc);
+            }
+
+        docNames.push_back(move(name));
+    }
+}
+
+void FuzzySearchIndex::addWord(const string& word, uint32_t doc) {
+    auto found = wordNode.find(word);
+    if (found != wordNode.end()) {
+        vector<uint32_t> &list = bkNodes[found->second].docs;
+        if (list.back() != doc) list.push_back(doc);
+        return;
+    }
+
+    uint32_t id = bkNodes.size();
+    bkNodes.push_back(BKNode{word, {doc}, {}});
+    wordNode[word] = id;
+    if (id == 0) return;    //first word becomes the root
+
+    //walk down the edge with the same distance until a free slot is found
+    uint32_t cur = 0;
+    while (true) {
+        int d = editDistance(word, bkNodes[cur].word);
+        uint32_t next = UINT32_MAX;
+        for (auto &child : bkNodes[cur].children) {
+            if (child.first == d) {
+                next = child.second;
+                break;
+            }
+        }
+        if (next == UINT32_MAX) {
+            bkNodes[cur].children.push_back({d, id});
+            return;
+        }
+        cur = next;
+    }
+}
+
+//all docs having a word within maxDistance edits of the query
+void FuzzySearchIndex::fuzzyDocs(const string& query, int maxDistance, vector<uint32_t>& out) const {
+    if (bkNodes.empty()) return;
+
+    vector<uint32_t> stack = {0};
+    while (!stack.empty()) {
+        const BKNode &node = bkNodes[stack.back()];
+        stack.pop_back();
+
+        //children only need d up to their largest key + maxDistance, beyond that nothing matches
+        int bound = maxDistance;
+        for (auto &child : node.children) bound = max(bound, child.first + maxDistance);
+
+        int d = editDistance(query, node.word, bound);
+        if (d <= maxDistance) out.insert(out.end(), node.docs.begin(), node.docs.end());
+
+        //triangle inequality: only subtrees at distance d-max..d+max can match
+        for (auto &child : node.children) {
+            if (child.first >= d - maxDistance && child.first <= d + maxDistance)
+                stack.push_back(child.second);
+        }
+    }
+}
+
+//all docs whose name contains the query
+void FuzzySearchIndex::substringDocs(const string& query, vector<uint32_t>& out) const {
+    if (query.empty()) {    //every name contains it
+        for (uint32_t doc = 0; doc < docNames.size(); doc++) out.push_back(doc);
+        return;
+    }
+
+    //1 or 2 bytes: the gram's posting list is exactly the answer, nothing to confirm
+    if (query.size() < 3) {
+        auto it = gramPostings.find(gramKey(query, 0, query.size()));
+        if (it != gramPostings.end()) out.insert(out.end(), it->second.begin(), it->second.end());
+        return;
+    }
+
+    //intersect the posting lists of the query trigrams, shortest list first
+    vector<const vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= query.size(); i++) {
+        auto it = gramPostings.find(gramKey(query, i, 3));
+        if (it == gramPostings.end()) return;    //some trigram never occurs
+        lists.push_back(&it->second);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+        return a->size() < b->size();
+    });
+
+    vector<uint32_t> candidates = *lists[0];
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+        vector<uint32_t> merged;
+        set_intersection(candidates.begin(), candidates.end(),
+                         lists[i]->begin(), lists[i]->end(), back_inserter(merged));
+        candidates.swap(merged);
+    }
+
+    //trigrams can match out of order, so confirm with a real substring check
+    namesChecked += candidates.size();
+    for (uint32_t doc : candidates) {
+        if (docNames[doc].find(query) != string::npos) out.push_back(doc);
+    }
+}
+
+vector<const Product*> FuzzySearchIndex::search(const string& query, int maxDistance) const {
+    string q = foldKey(query);
+    namesChecked = 0;
+
+    vector<uint32_t> hits;
+    fuzzyDocs(q, maxDistance, hits);
+    substringDocs(q, hits);
+
+    sort(hits.begin(), hits.end());
+    hits.erase(unique(hits.begin(), hits.end()), hits.end());
+
+    vector<const Product*> results;
+    results.reserve(hits.size());
+    for (uint32_t doc : hits) results.push_back(docs[doc]);
+    return results;
+}
@@ -0,0 +1,42 @@
+#ifndef FUZZY_INDEX_H
+#define FUZZY_INDEX_H
+
+#include "product.h"
+#include "edit_distance.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+//index for typo tolerant search: a product matches when one word of its name
+//is within maxDistance edits of the query, or the query is a substring of its name
+class FuzzySearchIndex {
+private:
+    //BK-tree over the distinct name words, children are keyed by edit distance
+    struct BKNode {
+        string word;
+        vector<uint32_t> docs;    //products containing this word
+        vector<pair<int, uint32_t>> children;
+    };
+
+    vector<const Product*> docs;    //doc id -> product
+    vector<string> docNames;    //folded names (foldKey), for substring checks
+    vector<BKNode> bkNodes;
+    unordered_map<string, uint32_t> wordNode;
+    //1, 2 and 3 byte substrings of the folded names -> sorted doc ids (see gramKey). queries up to
+    //3 bytes are answered by one list, longer ones intersect their trigram lists
+    unordered_map<uint32_t, vector<uint32_t>> gramPostings;
+    mutable size_t namesChecked = 0;    //substring checks done by the last search
+
+    void addWord(const string& word, uint32_t doc);
+    void fuzzyDocs(const string& query, int maxDistance, vector<uint32_t>& out) const;
+    void substringDocs(const string& query, vector<uint32_t>& out) const;
+
+public:
+    void build(const vector<const Product*>& products);    //products must outlive the index
+    vector<const Product*> search(const string& query, int maxDistance = 2) const;    //results in catalog order
+    size_t lastNamesChecked() const { return namesChecked; }
+};
+
+#endif
@@ -1,62 +1,344 @@
 #include "graph.h"
-#include <fstream>
-#include <sstream>
+#include "snapshot.h"
+#include "product.h"
+#include "mapped_file.h"
 #include <algorithm>
-#include <set>
+#include <cstring>
+#include <charconv>
+#include <cmath>
 
-// connecting two products for recommendation
-void RecommendationGraph::addEdge(const string& product1, const string& product2) {
-    // Convert both names to lowercase
-    string p1Lower = product1;
-    string p2Lower = product2;
-    transform(p1Lower.begin(), p1Lower.end(), p1Lower.begin(), ::tolower);
-    transform(p2Lower.begin(), p2Lower.end(), p2Lower.begin(), ::tolower);
-    
-    adjacencyList[p1Lower].push_back(p2Lower);
-    adjacencyList[p2Lower].push_back(p1Lower);
+//one direction of an edge, seq = position of its pair in the input
+struct Arc {
+    uint32_t from, to, seq;
+    float weight;
+};
+
+// sort the arcs once and lay them out row by row
+void RecommendationGraph::build(const vector<GraphEdge>& edges, size_t nodes) {
+    revision++;
+    vector<Arc> arcs;
+    arcs.reserve(edges.size() * 2);
+    for (size_t i = 0; i < edges.size(); i++) {
+        const GraphEdge &e = edges[i];
+        if (e.a == e.b || e.a >= nodes || e.b >= nodes || !(e.weight > 0)) continue;    //self loops, unknown ids
+        arcs.push_back({e.a, e.b, static_cast<uint32_t>(i), e.weight});
+        arcs.push_back({e.b, e.a, static_cast<uint32_t>(i), e.weight});
+    }
+
+    //group by node, repeats of a pair end up next to each other with the first one in front
+    sort(arcs.begin(), arcs.end(), [](const Arc& x, const Arc& y) {
+        if (x.from != y.from) return x.from < y.from;
+        if (x.to != y.to) return x.to < y.to;
+        return x.seq < y.seq;
+    });
+
+    //fold repeats into the first one, adding up the weights
+    size_t kept = 0;
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (kept > 0 && arcs[kept - 1].from == arcs[i].from && arcs[kept - 1].to == arcs[i].to)
+            arcs[kept - 1].weight += arcs[i].weight;
+        else
+            arcs[kept++] = arcs[i];
+    }
+    arcs.resize(kept);
+
+    offsets.assign(nodes + 1, 0);
+    neighbors.resize(arcs.size());
+    weights.resize(arcs.size());
+    size_t i = 0;
+    for (size_t node = 0; node < nodes; node++) {
+        offsets[node] = static_cast<uint32_t>(i);
+        size_t first = i;
+        while (i < arcs.size() && arcs[i].from == node) i++;
+
+        //heaviest first, equal weights keep the order of the input pairs
+        sort(arcs.begin() + first, arcs.begin() + i, [](const Arc& x, const Arc& y) {
+            if (x.weight != y.weight) return x.weight > y.weight;
+            return x.seq < y.seq;
+        });
+        for (size_t k = first; k < i; k++) {
+            neighbors[k] = arcs[k].to;
+            weights[k] = arcs[k].weight;
+        }
+    }
+    offsets[nodes] = static_cast<uint32_t>(i);
+}
+
+static inline string_view trimView(string_view s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == string_view::npos) return string_view();
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+
+bool RecommendationGraph::loadRecommendations(const string& filename) {
+    clear();
+    if (!catalog) return false;
+
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    // Format: product1|product2[|weight], names resolved straight from the mapping
+    vector<GraphEdge> edges;
+    const char* cur = file.data();
+    const char* last = cur + file.size();
+    while (cur < last) {
+        const char* nl = static_cast<const char*>(memchr(cur, '\n', last - cur));
+        const char* end = nl ? nl : last;
+        string_view line(cur, end - cur);
+        cur = end + 1;
+
+        if (line.empty() || line[0] == '#') continue;    // Skip empty lines or comments
+        size_t bar = line.find('|');
+        if (bar == string_view::npos) continue;
+        string_view first = line.substr(0, bar), second = line.substr(bar + 1);
+
+        GraphEdge e;
+        size_t bar2 = second.find('|');
+        if (bar2 != string_view::npos) {
+            string_view w = trimView(second.substr(bar2 + 1));
+            if (from_chars(w.data(), w.data() + w.size(), e.weight).ec != errc()) e.weight = 1.0f;
+            second = second.substr(0, bar2);
+        }
+
+        e.a = catalog->findId(trimView(first));
+        e.b = catalog->findId(trimView(second));
+        if (e.a == ProductManager::NO_ID || e.b == ProductManager::NO_ID) continue;
+        edges.push_back(e);
+    }
+
+    build(edges, catalog->size());
+    return true;
 }
 
 // Get recommended products based on a given product
-vector<string> RecommendationGraph::getRecommendations(const string& productName, int maxResults) {
-    string nameLower = productName;
-    transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
-    
-    vector<string> recommendations;
-    set<string> visited;
-
-    if (adjacencyList.find(nameLower) != adjacencyList.end()) {    //if product exists in the graph
-        for (const string& neighbor : adjacencyList[nameLower]) {    // Loop through directly connected products
-            if (visited.find(neighbor) == visited.end() && neighbor != nameLower) {
-                recommendations.push_back(neighbor);
-                visited.insert(neighbor);
-                
-                if (recommendations.size() >= maxResults) break;
-            }
+Neighbors RecommendationGraph::getRecommendations(uint32_t productId, size_t maxResults) const {
+    Neighbors row;
+    if (productId + size_t(1) >= offsets.size()) return row;    //product not in the graph
+
+    size_t first = offsets[productId];
+    row.ids = neighbors.data() + first;
+    row.weights = weights.data() + first;
+    row.count = min<size_t>(offsets[productId + 1] - first, maxResults);
+    return row;
+}
+
+void RecommendationGraph::clear() {
+    offsets.clear();
+    neighbors.clear();
+    weights.clear();
+    learned.clear();
+    basketEpoch.clear();
+    epoch = 0;
+    revision++;
+}
+
+const vector<LearnedEdge>& RecommendationGraph::learnedOf(uint32_t productId) const {
+    static const vector<LearnedEdge> none;
+    return productId < learned.size() ? learned[productId] : none;
+}
+
+float RecommendationGraph::decayed(const LearnedEdge& e) const {
+    double age = epoch - e.epoch;    //checkouts since the weight was last set
+    return static_cast<float>(e.weight * exp2(-age / COPURCHASE_HALF_LIFE));
+}
+
+//add amount to from -> to, bringing the old weight up to the current epoch first
+void RecommendationGraph::learn(uint32_t from, uint32_t to, float amount) {
+    vector<LearnedEdge> &row = learned[from];
+    for (LearnedEdge &e : row) {
+        if (e.id != to) continue;
+        e.weight = decayed(e) + amount;
+        e.epoch = epoch;
+        return;
+    }
+
+    if (row.size() < LEARNED_PER_PRODUCT) {
+        row.push_back({to, amount, epoch});
+        return;
+    }
+
+    //full: the new pair takes the place of the weakest one if it is worth more by now
+    size_t weakest = 0;
+    for (size_t i = 1; i < row.size(); i++)
+        if (decayed(row[i]) < decayed(row[weakest])) weakest = i;
+    if (decayed(row[weakest]) < amount) row[weakest] = {to, amount, epoch};
+}
+
+void RecommendationGraph::recordBasket(const vector<uint32_t>& products) {
+    size_t nodes = catalog ? catalog->size() : (offsets.empty() ? 0 : offsets.size() - 1);
+    if (learned.size() < nodes) learned.resize(nodes);
+    if (basketEpoch.size() < learned.size()) basketEpoch.resize(learned.size());
+    epoch++;
+
+    //distinct known products, capped so one huge basket cannot stall the checkout
+    uint32_t basket[BASKET_PAIR_LIMIT];
+    size_t n = 0;
+    for (uint32_t id : products) {
+        if (n == BASKET_PAIR_LIMIT) break;
+        if (id >= learned.size() || find(basket, basket + n, id) != basket + n) continue;
+        basket[n++] = id;
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = i + 1; j < n; j++) {
+            learn(basket[i], basket[j], 1.0f);
+            learn(basket[j], basket[i], 1.0f);
         }
+    if (n > 1)
+        for (size_t i = 0; i < n; i++) basketEpoch[basket[i]] = epoch;
+}
+
+//a checkout only rewrites the learned rows of its basket. decay fades all learned weights at the
+//same rate, so it reorders nothing in a row that has no file edges; a row mixing both kinds can
+//reorder at any checkout and follows the epoch
+uint64_t RecommendationGraph::productRevision(uint32_t productId) const {
+    uint32_t changed = 0;
+    if (productId < learned.size() && !learned[productId].empty()) {
+        bool fileEdges = productId + 1 < offsets.size() && offsets[productId + 1] > offsets[productId];
+        changed = fileEdges ? epoch : basketEpoch[productId];
     }
-    
-    return recommendations;
-}
-
-void RecommendationGraph::loadRecommendations(const string& filename) {
-    // Build simple co-purchase graph
-    // Format: product1|product2
-    ifstream file(filename);
-    if (!file.is_open()) {
-        return; 
-    }
-    
-    string line;    // Skip empty lines or comments
-    while (getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        
-        stringstream ss(line);
-        string prod1, prod2;
-        getline(ss, prod1, '|');
-        getline(ss, prod2);
-        
-        addEdge(prod1, prod2);
-    }
-    
-    file.close();
+    return static_cast<uint64_t>(revision) << 32 | changed;
+}
+
+//a is the better recommendation: higher score, or the same score and an earlier rank
+static inline bool better(const ScoredProduct& a, const ScoredProduct& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.rank < b.rank;
+}
+
+// bounded heap with the worst kept candidate on top, so each candidate costs O(log k)
+void RecommendationGraph::topRecommendations(uint32_t productId, size_t k, vector<ScoredProduct>& out) const {
+    out.clear();
+    if (k == 0) return;
+
+    auto offer = [&](const ScoredProduct& c) {
+        if (out.size() < k) {
+            out.push_back(c);
+            push_heap(out.begin(), out.end(), better);
+        } else if (better(c, out.front())) {
+            pop_heap(out.begin(), out.end(), better);
+            out.back() = c;
+            push_heap(out.begin(), out.end(), better);
+        }
+    };
+
+    const vector<LearnedEdge> &mine = learnedOf(productId);
+    Neighbors row = getRecommendations(productId, SIZE_MAX);
+
+    //file edges, plus whatever was learned for the same pair
+    for (size_t i = 0; i < row.size(); i++) {
+        float score = row.weight(i);
+        for (const LearnedEdge &e : mine)
+            if (e.id == row[i]) score += decayed(e);
+        offer({row[i], score, static_cast<uint32_t>(i)});
+    }
+
+    //pairs known only from checkouts
+    for (size_t j = 0; j < mine.size(); j++) {
+        if (find(row.begin(), row.end(), mine[j].id) != row.end()) continue;
+        offer({mine[j].id, decayed(mine[j]), static_cast<uint32_t>(row.size() + j)});
+    }
+
+    sort_heap(out.begin(), out.end(), better);    //best first
+}
+
+bool RecommendationGraph::saveLearned(const string& filename) const {
+    if (!catalog) return false;
+    string out = "#epoch " + to_string(epoch) + "\n";
+    for (size_t from = 0; from < learned.size(); from++) {
+        for (const LearnedEdge &e : learned[from]) {
+            out += catalog->getProduct(static_cast<uint32_t>(from))->name;
+            out += '|';
+            out += catalog->getProduct(e.id)->name;
+            out += '|' + to_string(e.weight) + '|' + to_string(e.epoch) + '\n';
+        }
+    }
+    return replaceFile(filename, out, false);
+}
+
+void RecommendationGraph::loadLearned(const string& filename) {
+    learned.clear();
+    basketEpoch.clear();
+    epoch = 0;
+    revision++;
+    if (!catalog) return;
+    learned.resize(catalog->size());
+    basketEpoch.resize(catalog->size());
+
+    MappedFile file;
+    if (!file.open(filename)) return;
+
+    const char* cur = file.data();
+    const char* last = cur + file.size();
+    while (cur < last) {
+        const char* nl = static_cast<const char*>(memchr(cur, '\n', last - cur));
+        const char* end = nl ? nl : last;
+        string_view line(cur, end - cur);
+        cur = end + 1;
+
+        if (line.rfind("#epoch ", 0) == 0) {
+            from_chars(line.data() + 7, line.data() + line.size(), epoch);
+            continue;
+        }
+
+        //from|to|weight|epoch, split from the right since only names could hold odd text
+        size_t b3 = line.rfind('|');
+        if (b3 == string_view::npos || b3 == 0) continue;
+        size_t b2 = line.rfind('|', b3 - 1);
+        if (b2 == string_view::npos || b2 == 0) continue;
+        size_t b1 = line.rfind('|', b2 - 1);
+        if (b1 == string_view::npos) continue;
+
+        LearnedEdge e{};
+        string_view w = line.substr(b2 + 1, b3 - b2 - 1), ep = line.substr(b3 + 1);
+        if (from_chars(w.data(), w.data() + w.size(), e.weight).ec != errc()) continue;
+        if (from_chars(ep.data(), ep.data() + ep.size(), e.epoch).ec != errc()) continue;
+        uint32_t from = catalog->findId(line.substr(0, b1));
+        e.id = catalog->findId(line.substr(b1 + 1, b2 - b1 - 1));
+        if (from == ProductManager::NO_ID || e.id == ProductManager::NO_ID || from == e.id) continue;
+        if (learned[from].size() < LEARNED_PER_PRODUCT) learned[from].push_back(e);
+        epoch = max(epoch, e.epoch);    //a lost header must not make entries look newer than now
+    }
+}
+
+void RecommendationGraph::writeSnapshot(SnapshotWriter& w) const {
+    w.putU32(static_cast<uint32_t>(offsets.size()));
+    w.putBytes(offsets.data(), offsets.size() * sizeof(uint32_t));
+    w.putU32(static_cast<uint32_t>(neighbors.size()));
+    w.putBytes(neighbors.data(), neighbors.size() * sizeof(uint32_t));
+    w.putBytes(weights.data(), weights.size() * sizeof(float));
+}
+
+bool RecommendationGraph::readSnapshot(SnapshotReader& r) {
+    revision++;
+    vector<uint32_t> loadedOffsets(r.getCount(sizeof(uint32_t)));
+    const char* p = r.take(loadedOffsets.size() * sizeof(uint32_t));
+    if (!p) return false;
+    memcpy(loadedOffsets.data(), p, loadedOffsets.size() * sizeof(uint32_t));
+
+    vector<uint32_t> loadedNeighbors(r.getCount(sizeof(uint32_t) + sizeof(float)));    //weights follow
+    p = r.take(loadedNeighbors.size() * sizeof(uint32_t));
+    if (!p) return false;
+    memcpy(loadedNeighbors.data(), p, loadedNeighbors.size() * sizeof(uint32_t));
+
+    vector<float> loadedWeights(loadedNeighbors.size());
+    p = r.take(loadedWeights.size() * sizeof(float));
+    if (!p) return false;
+    memcpy(loadedWeights.data(), p, loadedWeights.size() * sizeof(float));
+
+    //rows must be in range and ascending, neighbours must be nodes
+    size_t nodes = loadedOffsets.empty() ? 0 : loadedOffsets.size() - 1;
+    if (!loadedOffsets.empty() && (loadedOffsets[0] != 0 || loadedOffsets[nodes] != loadedNeighbors.size()))
+        return false;
+    if (loadedOffsets.empty() && !loadedNeighbors.empty()) return false;
+    for (size_t i = 0; i < nodes; i++)
+        if (loadedOffsets[i] > loadedOffsets[i + 1]) return false;
+    for (uint32_t n : loadedNeighbors)
+        if (n >= nodes) return false;
+
+    offsets.swap(loadedOffsets);
+    neighbors.swap(loadedNeighbors);
+    weights.swap(loadedWeights);
+    return true;
 }
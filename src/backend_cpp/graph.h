@@ -3,18 +3,98 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 using namespace std;
 
-// Graph that stores product recommendations
+class SnapshotWriter;
+class SnapshotReader;
+class ProductManager;
+
+//one undirected co-purchase pair, weight = how strongly the two go together
+struct GraphEdge {
+    uint32_t a, b;
+    float weight = 1.0f;
+};
+
+//read-only slice of one graph row, no copies. valid until the graph is rebuilt
+struct Neighbors {
+    const uint32_t* ids = nullptr;
+    const float* weights = nullptr;
+    size_t count = 0;
+
+    const uint32_t* begin() const { return ids; }
+    const uint32_t* end() const { return ids + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint32_t operator[](size_t i) const { return ids[i]; }
+    float weight(size_t i) const { return weights[i]; }
+};
+
+//co-purchase weights learned from checkouts fade by half every this many checkouts
+const double COPURCHASE_HALF_LIFE = 500.0;
+const size_t LEARNED_PER_PRODUCT = 32;    //a full row replaces its weakest entry
+const size_t BASKET_PAIR_LIMIT = 16;    //only the first 16 products of a basket are paired, O(16^2) per checkout
+
+//co-purchase count of one neighbour, weight is as of epoch (decay is applied when read)
+struct LearnedEdge {
+    uint32_t id;
+    float weight;
+    uint32_t epoch;
+};
+
+//one recommendation candidate, rank breaks score ties (file order first, then learned)
+struct ScoredProduct {
+    uint32_t id;
+    float score;
+    uint32_t rank;
+};
+
+// Graph that stores product recommendations, nodes are product ids.
+// compressed sparse row layout: the neighbours of p are neighbors[offsets[p] .. offsets[p + 1]),
+// without duplicates or self loops, heaviest first (ties in the order the pairs were first given)
 class RecommendationGraph {
 private:
-    map<string, vector<string>> adjacencyList;
-    
+    vector<uint32_t> offsets;    //nodes + 1 entries, empty for an empty graph
+    vector<uint32_t> neighbors;
+    vector<float> weights;    //parallel to neighbors
+    const ProductManager* catalog = nullptr;    //resolves the names in the edge file
+
+    vector<vector<LearnedEdge>> learned;    //product id -> co-purchased products, unordered
+    uint32_t epoch = 0;    //checkouts recorded so far
+    uint32_t revision = 0;    //bumped when the graph is rebuilt or reloaded
+    vector<uint32_t> basketEpoch;    //product id -> last checkout that changed its learned row
+
+    void learn(uint32_t from, uint32_t to, float amount);
+
 public:
-    void addEdge(const string& product1, const string& product2);    // Connect two products (means they are related)
-    vector<string> getRecommendations(const string& productName, int maxResults = 5); // Get recommended products for a given product
-    void loadRecommendations(const string& filename);
+    void attach(const ProductManager& pm) { catalog = &pm; }
+
+    //bulk build from undirected pairs, repeated pairs add up their weights. replaces the current graph
+    void build(const vector<GraphEdge>& edges, size_t nodes);
+    bool loadRecommendations(const string& filename);    //product1|product2[|weight] lines, unknown names are skipped
+    //the best maxResults neighbours of a product: a slice of the row, O(1) and no allocation
+    Neighbors getRecommendations(uint32_t productId, size_t maxResults = 5) const;
+    size_t edgeCount() const { return neighbors.size() / 2; }
+    size_t nodeCount() const { return max(offsets.empty() ? size_t(0) : offsets.size() - 1, learned.size()); }
+    const vector<LearnedEdge>& learnedOf(uint32_t productId) const;    //empty if none
+    float decayed(const LearnedEdge& e) const;    //learned weight as of the latest checkout
+    void clear();    //static and learned edges
+    uint32_t getRevision() const { return revision; }    //results computed at another revision may be stale
+    //changes whenever topRecommendations() of this product can change, O(1)
+    uint64_t productRevision(uint32_t productId) const;
+
+    //checkout path: every pair of products in the basket gets bought-together weight, O(pairs)
+    void recordBasket(const vector<uint32_t>& products);
+    //best k products by file weight + decayed learned weight, best first. out is reused, so a
+    //caller that keeps it around does not allocate
+    void topRecommendations(uint32_t productId, size_t k, vector<ScoredProduct>& out) const;
+    bool saveLearned(const string& filename) const;    //name|name|weight|epoch lines
+    void loadLearned(const string& filename);
+
+    void writeSnapshot(SnapshotWriter& w) const;
+    bool readSnapshot(SnapshotReader& r);
 };
 
 #endif
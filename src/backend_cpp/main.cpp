@@ -3,18 +3,40 @@
 #include <sstream>
 #include <algorithm>
 #include <string>
+#include <map>
 #include <direct.h>
 #include "product.h"
 #include "trie.h"
 #include "cart.h"
 #include "graph.h"
+#include "personalized_rank.h"
+#include "recommend_cache.h"
+#include "snapshot.h"
+#include "fuzzy_index.h"
+#include "sort_engine.h"
 
 using namespace std;
 
+const size_t DEFAULT_AUTOCOMP_LIMIT = 10;    //suggestions returned when no limit is given
+const size_t STREAM_CHUNK_ROWS = 64;    //rows written between flushes in server mode
+
+//offset/limit window requested by a list command
+struct PageRequest {
+    size_t offset = 0;
+    size_t limit = SIZE_MAX;
+};
+
+bool serverMode = false;
+size_t rowsSinceFlush = 0;
+
 ProductManager productManager;
 Trie searchTrie;
-ShoppingCart cart;
+StockJournal stockJournal(productManager);
+ShoppingCart cart(productManager, &stockJournal);
 RecommendationGraph recommendGraph;
+PersonalizedRanker cartRanker(recommendGraph);    //"complete your cart" suggestions
+RecommendCache recommendCache;    //rendered RECOMMEND responses of hot products
+FuzzySearchIndex searchIndex;
 
 void setWorkingDirectory() {
     char buffer[1024];
@@ -73,711 +95,224 @@ ProductFilters parseFilterString(const string &s) {
     return f;
 }
 
-void initializeSystem() {    //loading all the products,cart data,build trie,and build recommendation graph
-    setWorkingDirectory();  
-    productManager.loadProducts("products.txt");        
-    cart.loadFromFile();    //restore cart state
+//list commands take options after the last '|': "AUTOCOMP app |limit=5;rank=stock"
+//'|' is the products.txt field separator, so it never appears in names
+map<string, string> splitCommandOptions(string &arg) {
+    map<string, string> opts;
+    size_t bar = arg.find_last_of('|');
+    if (bar == string::npos) return opts;
+
+    stringstream ss(arg.substr(bar + 1));
+    arg = trim(arg.substr(0, bar));
 
-    //autocomplete trie
-    vector<Product> allProducts = productManager.getAllProducts();
-    for (const auto &product : allProducts) {
-        searchTrie.insert(product.name);
+    string part;
+    while (getline(ss, part, ';')) {
+        size_t eq = part.find('=');
+        if (eq == string::npos) continue;
+        opts[trim(part.substr(0, eq))] = trim(part.substr(eq + 1));
     }
+    return opts;
+}
 
-    //edges for showing recommendations and products that are bought together
-    recommendGraph.addEdge("Apple iPhone 15", "Apple MacBook Air M3");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple iPad Pro 12.9");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple Watch Series 9");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple AirTag 4-Pack");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple AirPods Pro 2");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple iPhone 15", "Samsung 45W Charger");
-    recommendGraph.addEdge("Apple iPhone 15", "Boat Type-C Cable");
-    recommendGraph.addEdge("Apple iPhone 15", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Apple iPhone 15", "OtterBox Defender Case");
-    recommendGraph.addEdge("Apple iPhone 15", "HP USB-C Dock");
-    recommendGraph.addEdge("Apple iPhone 15", "Anker Wireless Charger");
-    recommendGraph.addEdge("Apple iPhone 15", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Apple iPhone 15", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple iPhone 15", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple iPhone 15", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Apple iPhone 15", "Baseus Car Charger");
-    recommendGraph.addEdge("Apple iPhone 15", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Apple iPhone 15", "Apple Lightning Cable");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung Galaxy Tab S9");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung Galaxy Watch 6");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung Galaxy Fit 3");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung 340L Refrigerator");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung Microwave 28L");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Boat Type-C Cable");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Samsung Galaxy S24", "OtterBox Defender Case");
-    recommendGraph.addEdge("Samsung Galaxy S24", "HP USB-C Dock");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Anker Wireless Charger");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Samsung Galaxy S24", "JBL Audio Cable");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Apple Pencil 2");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Samsung Galaxy S24", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Baseus Car Charger");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Samsung Galaxy S24", "Apple Lightning Cable");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Samsung 45W Charger");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Boat Type-C Cable");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "OtterBox Defender Case");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "HP USB-C Dock");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Anker Wireless Charger");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "JBL Audio Cable");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Apple Pencil 2");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Baseus Car Charger");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Google Pixel 9 Pro", "Apple Lightning Cable");
-    recommendGraph.addEdge("OnePlus 12", "Apple MagSafe Charger");
-    recommendGraph.addEdge("OnePlus 12", "Samsung 45W Charger");
-    recommendGraph.addEdge("OnePlus 12", "Boat Type-C Cable");
-    recommendGraph.addEdge("OnePlus 12", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("OnePlus 12", "OtterBox Defender Case");
-    recommendGraph.addEdge("OnePlus 12", "HP USB-C Dock");
-    recommendGraph.addEdge("OnePlus 12", "Anker Wireless Charger");
-    recommendGraph.addEdge("OnePlus 12", "Belkin HDMI Cable");
-    recommendGraph.addEdge("OnePlus 12", "JBL Audio Cable");
-    recommendGraph.addEdge("OnePlus 12", "Apple Pencil 2");
-    recommendGraph.addEdge("OnePlus 12", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("OnePlus 12", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("OnePlus 12", "Baseus Car Charger");
-    recommendGraph.addEdge("OnePlus 12", "Ugreen USB Adapter");
-    recommendGraph.addEdge("OnePlus 12", "Apple Lightning Cable");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Samsung 45W Charger");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Boat Type-C Cable");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "OtterBox Defender Case");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "HP USB-C Dock");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Anker Wireless Charger");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "JBL Audio Cable");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Apple Pencil 2");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Baseus Car Charger");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Xiaomi 14 Pro", "Apple Lightning Cable");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Sony WH-1000XM5");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Sony WF-1000XM5");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Sony XB13 Portable Speaker");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Sony PlayStation 5");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Samsung 45W Charger");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Boat Type-C Cable");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "OtterBox Defender Case");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "HP USB-C Dock");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Anker Wireless Charger");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "JBL Audio Cable");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Apple Pencil 2");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Baseus Car Charger");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Sony Bravia 55-inch 4K TV", "Apple Lightning Cable");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Apple MagSafe Charger");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Samsung 45W Charger");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Boat Type-C Cable");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "OtterBox Defender Case");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "HP USB-C Dock");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Anker Wireless Charger");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Belkin HDMI Cable");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "JBL Audio Cable");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Apple Pencil 2");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Baseus Car Charger");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Ugreen USB Adapter");
-    recommendGraph.addEdge("LG OLED C3 65-inch TV", "Apple Lightning Cable");
-    recommendGraph.addEdge("Dell XPS 13", "Dell Inspiron 15");
-    recommendGraph.addEdge("Dell XPS 13", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Dell XPS 13", "Samsung 45W Charger");
-    recommendGraph.addEdge("Dell XPS 13", "Boat Type-C Cable");
-    recommendGraph.addEdge("Dell XPS 13", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Dell XPS 13", "OtterBox Defender Case");
-    recommendGraph.addEdge("Dell XPS 13", "HP USB-C Dock");
-    recommendGraph.addEdge("Dell XPS 13", "Anker Wireless Charger");
-    recommendGraph.addEdge("Dell XPS 13", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Dell XPS 13", "JBL Audio Cable");
-    recommendGraph.addEdge("Dell XPS 13", "Apple Pencil 2");
-    recommendGraph.addEdge("Dell XPS 13", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Dell XPS 13", "Dell Laptop Sleeve 15");
-    recommendGraph.addEdge("Dell XPS 13", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Dell XPS 13", "Baseus Car Charger");
-    recommendGraph.addEdge("Dell XPS 13", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Dell XPS 13", "Apple Lightning Cable");
-    recommendGraph.addEdge("HP Spectre x360", "HP Envy 13");
-    recommendGraph.addEdge("HP Spectre x360", "Dyson Air Purifier HP07");
-    recommendGraph.addEdge("HP Spectre x360", "Apple MagSafe Charger");
-    recommendGraph.addEdge("HP Spectre x360", "Samsung 45W Charger");
-    recommendGraph.addEdge("HP Spectre x360", "Boat Type-C Cable");
-    recommendGraph.addEdge("HP Spectre x360", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("HP Spectre x360", "OtterBox Defender Case");
-    recommendGraph.addEdge("HP Spectre x360", "HP USB-C Dock");
-    recommendGraph.addEdge("HP Spectre x360", "Anker Wireless Charger");
-    recommendGraph.addEdge("HP Spectre x360", "Belkin HDMI Cable");
-    recommendGraph.addEdge("HP Spectre x360", "JBL Audio Cable");
-    recommendGraph.addEdge("HP Spectre x360", "Apple Pencil 2");
-    recommendGraph.addEdge("HP Spectre x360", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("HP Spectre x360", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("HP Spectre x360", "Baseus Car Charger");
-    recommendGraph.addEdge("HP Spectre x360", "Ugreen USB Adapter");
-    recommendGraph.addEdge("HP Spectre x360", "Apple Lightning Cable");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Samsung 45W Charger");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Boat Type-C Cable");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "OtterBox Defender Case");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "HP USB-C Dock");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Anker Wireless Charger");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "JBL Audio Cable");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Apple Pencil 2");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Baseus Car Charger");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Lenovo ThinkPad X1 Carbon", "Apple Lightning Cable");
-    recommendGraph.addEdge("Asus ZenBook 14", "Asus ROG Zephyrus G14");
-    recommendGraph.addEdge("Asus ZenBook 14", "ASUS ROG Ally");
-    recommendGraph.addEdge("Asus ZenBook 14", "Asus TUF Gaming Monitor 27");
-    recommendGraph.addEdge("Asus ZenBook 14", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Asus ZenBook 14", "Samsung 45W Charger");
-    recommendGraph.addEdge("Asus ZenBook 14", "Boat Type-C Cable");
-    recommendGraph.addEdge("Asus ZenBook 14", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Asus ZenBook 14", "OtterBox Defender Case");
-    recommendGraph.addEdge("Asus ZenBook 14", "HP USB-C Dock");
-    recommendGraph.addEdge("Asus ZenBook 14", "Anker Wireless Charger");
-    recommendGraph.addEdge("Asus ZenBook 14", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Asus ZenBook 14", "JBL Audio Cable");
-    recommendGraph.addEdge("Asus ZenBook 14", "Apple Pencil 2");
-    recommendGraph.addEdge("Asus ZenBook 14", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Asus ZenBook 14", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Asus ZenBook 14", "Baseus Car Charger");
-    recommendGraph.addEdge("Asus ZenBook 14", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Asus ZenBook 14", "Apple Lightning Cable");
-    recommendGraph.addEdge("Acer Swift 5", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Acer Swift 5", "Samsung 45W Charger");
-    recommendGraph.addEdge("Acer Swift 5", "Boat Type-C Cable");
-    recommendGraph.addEdge("Acer Swift 5", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Acer Swift 5", "OtterBox Defender Case");
-    recommendGraph.addEdge("Acer Swift 5", "HP USB-C Dock");
-    recommendGraph.addEdge("Acer Swift 5", "Anker Wireless Charger");
-    recommendGraph.addEdge("Acer Swift 5", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Acer Swift 5", "JBL Audio Cable");
-    recommendGraph.addEdge("Acer Swift 5", "Apple Pencil 2");
-    recommendGraph.addEdge("Acer Swift 5", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Acer Swift 5", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Acer Swift 5", "Baseus Car Charger");
-    recommendGraph.addEdge("Acer Swift 5", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Acer Swift 5", "Apple Lightning Cable");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Samsung 45W Charger");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Boat Type-C Cable");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "OtterBox Defender Case");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "HP USB-C Dock");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Anker Wireless Charger");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "JBL Audio Cable");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Apple Pencil 2");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Baseus Car Charger");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Microsoft Surface Laptop 5", "Apple Lightning Cable");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple iPad Pro 12.9");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple Watch Series 9");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple AirTag 4-Pack");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple AirPods Pro 2");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Samsung 45W Charger");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Boat Type-C Cable");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Apple MacBook Air M3", "OtterBox Defender Case");
-    recommendGraph.addEdge("Apple MacBook Air M3", "HP USB-C Dock");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Anker Wireless Charger");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Apple MacBook Air M3", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple MacBook Air M3", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Baseus Car Charger");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Apple MacBook Air M3", "Apple Lightning Cable");
-    recommendGraph.addEdge("Dell Inspiron 15", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Dell Inspiron 15", "Samsung 45W Charger");
-    recommendGraph.addEdge("Dell Inspiron 15", "Boat Type-C Cable");
-    recommendGraph.addEdge("Dell Inspiron 15", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Dell Inspiron 15", "OtterBox Defender Case");
-    recommendGraph.addEdge("Dell Inspiron 15", "HP USB-C Dock");
-    recommendGraph.addEdge("Dell Inspiron 15", "Anker Wireless Charger");
-    recommendGraph.addEdge("Dell Inspiron 15", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Dell Inspiron 15", "JBL Audio Cable");
-    recommendGraph.addEdge("Dell Inspiron 15", "Apple Pencil 2");
-    recommendGraph.addEdge("Dell Inspiron 15", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Dell Inspiron 15", "Dell Laptop Sleeve 15");
-    recommendGraph.addEdge("Dell Inspiron 15", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Dell Inspiron 15", "Baseus Car Charger");
-    recommendGraph.addEdge("Dell Inspiron 15", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Dell Inspiron 15", "Apple Lightning Cable");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "ASUS ROG Ally");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Asus TUF Gaming Monitor 27");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Samsung 45W Charger");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Boat Type-C Cable");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "OtterBox Defender Case");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "HP USB-C Dock");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Anker Wireless Charger");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "JBL Audio Cable");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Apple Pencil 2");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Baseus Car Charger");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Asus ROG Zephyrus G14", "Apple Lightning Cable");
-    recommendGraph.addEdge("HP Envy 13", "Dyson Air Purifier HP07");
-    recommendGraph.addEdge("HP Envy 13", "Apple MagSafe Charger");
-    recommendGraph.addEdge("HP Envy 13", "Samsung 45W Charger");
-    recommendGraph.addEdge("HP Envy 13", "Boat Type-C Cable");
-    recommendGraph.addEdge("HP Envy 13", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("HP Envy 13", "OtterBox Defender Case");
-    recommendGraph.addEdge("HP Envy 13", "HP USB-C Dock");
-    recommendGraph.addEdge("HP Envy 13", "Anker Wireless Charger");
-    recommendGraph.addEdge("HP Envy 13", "Belkin HDMI Cable");
-    recommendGraph.addEdge("HP Envy 13", "JBL Audio Cable");
-    recommendGraph.addEdge("HP Envy 13", "Apple Pencil 2");
-    recommendGraph.addEdge("HP Envy 13", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("HP Envy 13", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("HP Envy 13", "Baseus Car Charger");
-    recommendGraph.addEdge("HP Envy 13", "Ugreen USB Adapter");
-    recommendGraph.addEdge("HP Envy 13", "Apple Lightning Cable");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple Watch Series 9");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple AirTag 4-Pack");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple AirPods Pro 2");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Samsung 45W Charger");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Boat Type-C Cable");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "OtterBox Defender Case");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "HP USB-C Dock");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Anker Wireless Charger");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Baseus Car Charger");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Apple iPad Pro 12.9", "Apple Lightning Cable");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung Galaxy Watch 6");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung Galaxy Fit 3");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung 340L Refrigerator");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung Microwave 28L");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Boat Type-C Cable");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "OtterBox Defender Case");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "HP USB-C Dock");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Anker Wireless Charger");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "JBL Audio Cable");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Apple Pencil 2");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Baseus Car Charger");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Samsung Galaxy Tab S9", "Apple Lightning Cable");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Samsung 45W Charger");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Boat Type-C Cable");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "OtterBox Defender Case");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "HP USB-C Dock");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Anker Wireless Charger");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "JBL Audio Cable");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Apple Pencil 2");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Baseus Car Charger");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Amazon Kindle Oasis", "Apple Lightning Cable");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple AirTag 4-Pack");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple AirPods Pro 2");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple Watch Series 9", "Samsung 45W Charger");
-    recommendGraph.addEdge("Apple Watch Series 9", "Boat Type-C Cable");
-    recommendGraph.addEdge("Apple Watch Series 9", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Apple Watch Series 9", "OtterBox Defender Case");
-    recommendGraph.addEdge("Apple Watch Series 9", "HP USB-C Dock");
-    recommendGraph.addEdge("Apple Watch Series 9", "Anker Wireless Charger");
-    recommendGraph.addEdge("Apple Watch Series 9", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Apple Watch Series 9", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple Watch Series 9", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple Watch Series 9", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Apple Watch Series 9", "Baseus Car Charger");
-    recommendGraph.addEdge("Apple Watch Series 9", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Apple Watch Series 9", "Apple Lightning Cable");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Samsung Galaxy Fit 3");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Samsung 340L Refrigerator");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Samsung Microwave 28L");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Boat Type-C Cable");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "OtterBox Defender Case");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "HP USB-C Dock");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Anker Wireless Charger");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "JBL Audio Cable");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Apple Pencil 2");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Baseus Car Charger");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Samsung Galaxy Watch 6", "Apple Lightning Cable");
-    recommendGraph.addEdge("Google Nest Hub 2", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Google Nest Hub 2", "Samsung 45W Charger");
-    recommendGraph.addEdge("Google Nest Hub 2", "Boat Type-C Cable");
-    recommendGraph.addEdge("Google Nest Hub 2", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Google Nest Hub 2", "OtterBox Defender Case");
-    recommendGraph.addEdge("Google Nest Hub 2", "HP USB-C Dock");
-    recommendGraph.addEdge("Google Nest Hub 2", "Anker Wireless Charger");
-    recommendGraph.addEdge("Google Nest Hub 2", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Google Nest Hub 2", "JBL Audio Cable");
-    recommendGraph.addEdge("Google Nest Hub 2", "Apple Pencil 2");
-    recommendGraph.addEdge("Google Nest Hub 2", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Google Nest Hub 2", "Mi 10000mAh Power Bank");
-    recommendGraph.addEdge("Google Nest Hub 2", "Dell Laptop Sleeve 15");
-    recommendGraph.addEdge("Google Nest Hub 2", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Google Nest Hub 2", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Google Nest Hub 2", "Baseus Car Charger");
-    recommendGraph.addEdge("Google Nest Hub 2", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Google Nest Hub 2", "Kingston 128GB Flash Drive");
-    recommendGraph.addEdge("Google Nest Hub 2", "Sandisk 1TB SSD");
-    recommendGraph.addEdge("Google Nest Hub 2", "Apple Lightning Cable");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Apple AirPods Pro 2");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Samsung 45W Charger");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Boat Type-C Cable");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "OtterBox Defender Case");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "HP USB-C Dock");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Anker Wireless Charger");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Baseus Car Charger");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Apple AirTag 4-Pack", "Apple Lightning Cable");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Anker Soundcore Life Q30");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Samsung 45W Charger");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Boat Type-C Cable");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Anker PowerCore 20000", "OtterBox Defender Case");
-    recommendGraph.addEdge("Anker PowerCore 20000", "HP USB-C Dock");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Anker Wireless Charger");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Anker PowerCore 20000", "JBL Audio Cable");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Apple Pencil 2");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Anker PowerCore 20000", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Baseus Car Charger");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Anker PowerCore 20000", "Apple Lightning Cable");
-    recommendGraph.addEdge("Sony WH-1000XM5", "Sony WF-1000XM5");
-    recommendGraph.addEdge("Sony WH-1000XM5", "Sony XB13 Portable Speaker");
-    recommendGraph.addEdge("Sony WH-1000XM5", "Sony PlayStation 5");
-    recommendGraph.addEdge("Sony WH-1000XM5", "JBL Audio Cable");
-    recommendGraph.addEdge("Bose QuietComfort Ultra", "Bose SoundLink Revolve+");
-    recommendGraph.addEdge("Bose QuietComfort Ultra", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple AirPods Pro 2", "Apple Watch Ultra 2");
-    recommendGraph.addEdge("Apple AirPods Pro 2", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple AirPods Pro 2", "JBL Audio Cable");
-    recommendGraph.addEdge("Apple AirPods Pro 2", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple AirPods Pro 2", "Apple Lightning Cable");
-    recommendGraph.addEdge("JBL Charge 5 Speaker", "JBL Tune 760NC");
-    recommendGraph.addEdge("JBL Charge 5 Speaker", "JBL Audio Cable");
-    recommendGraph.addEdge("Marshall Emberton II", "JBL Audio Cable");
-    recommendGraph.addEdge("Sony WF-1000XM5", "Sony XB13 Portable Speaker");
-    recommendGraph.addEdge("Sony WF-1000XM5", "Sony PlayStation 5");
-    recommendGraph.addEdge("Sony WF-1000XM5", "JBL Audio Cable");
-    recommendGraph.addEdge("Sennheiser Momentum 4", "JBL Audio Cable");
-    recommendGraph.addEdge("boAt Rockerz 550", "JBL Audio Cable");
-    recommendGraph.addEdge("Zebronics Soundbar Z900", "JBL Audio Cable");
-    recommendGraph.addEdge("Sony XB13 Portable Speaker", "Sony PlayStation 5");
-    recommendGraph.addEdge("Sony XB13 Portable Speaker", "JBL Audio Cable");
-    recommendGraph.addEdge("JBL Tune 760NC", "JBL Audio Cable");
-    recommendGraph.addEdge("Logitech Z407 Speaker", "Logitech G Pro Wireless Mouse");
-    recommendGraph.addEdge("Logitech Z407 Speaker", "Logitech G923 Racing Wheel");
-    recommendGraph.addEdge("Logitech Z407 Speaker", "JBL Audio Cable");
-    recommendGraph.addEdge("Logitech Z407 Speaker", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Anker Soundcore Life Q30", "Anker Wireless Charger");
-    recommendGraph.addEdge("Anker Soundcore Life Q30", "JBL Audio Cable");
-    recommendGraph.addEdge("Beats Studio Pro", "JBL Audio Cable");
-    recommendGraph.addEdge("Bose SoundLink Revolve+", "JBL Audio Cable");
-    recommendGraph.addEdge("Philips TAH8506BK", "JBL Audio Cable");
-    recommendGraph.addEdge("Jabra Elite 8 Active", "JBL Audio Cable");
-    recommendGraph.addEdge("Realme Buds Air 5", "JBL Audio Cable");
-    recommendGraph.addEdge("Skullcandy Hesh ANC", "JBL Audio Cable");
-    recommendGraph.addEdge("Noise Evolve 3", "JBL Audio Cable");
-    recommendGraph.addEdge("Sony PlayStation 5", "Boat Type-C Cable");
-    recommendGraph.addEdge("Sony PlayStation 5", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Sony PlayStation 5", "JBL Audio Cable");
-    recommendGraph.addEdge("Sony PlayStation 5", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Sony PlayStation 5", "Apple Lightning Cable");
-    recommendGraph.addEdge("Microsoft Xbox Series X", "Boat Type-C Cable");
-    recommendGraph.addEdge("Microsoft Xbox Series X", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Microsoft Xbox Series X", "JBL Audio Cable");
-    recommendGraph.addEdge("Microsoft Xbox Series X", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Microsoft Xbox Series X", "Apple Lightning Cable");
-    recommendGraph.addEdge("Nintendo Switch OLED", "Boat Type-C Cable");
-    recommendGraph.addEdge("Nintendo Switch OLED", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Nintendo Switch OLED", "JBL Audio Cable");
-    recommendGraph.addEdge("Nintendo Switch OLED", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Nintendo Switch OLED", "Apple Lightning Cable");
-    recommendGraph.addEdge("ASUS ROG Ally", "Asus TUF Gaming Monitor 27");
-    recommendGraph.addEdge("ASUS ROG Ally", "Boat Type-C Cable");
-    recommendGraph.addEdge("ASUS ROG Ally", "Belkin HDMI Cable");
-    recommendGraph.addEdge("ASUS ROG Ally", "JBL Audio Cable");
-    recommendGraph.addEdge("ASUS ROG Ally", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("ASUS ROG Ally", "Apple Lightning Cable");
-    recommendGraph.addEdge("Steam Deck 512GB", "Boat Type-C Cable");
-    recommendGraph.addEdge("Steam Deck 512GB", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Steam Deck 512GB", "JBL Audio Cable");
-    recommendGraph.addEdge("Steam Deck 512GB", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Steam Deck 512GB", "Apple Lightning Cable");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Samsung 45W Charger");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Boat Type-C Cable");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "OtterBox Defender Case");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "HP USB-C Dock");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Anker Wireless Charger");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "JBL Audio Cable");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Apple Pencil 2");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Mi 10000mAh Power Bank");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Dell Laptop Sleeve 15");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Baseus Car Charger");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Kingston 128GB Flash Drive");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Sandisk 1TB SSD");
-    recommendGraph.addEdge("Razer BlackWidow V4 Keyboard", "Apple Lightning Cable");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Logitech G923 Racing Wheel");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Samsung 45W Charger");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Boat Type-C Cable");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Spigen iPhone 15 Case");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "OtterBox Defender Case");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "HP USB-C Dock");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Anker Wireless Charger");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "JBL Audio Cable");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Apple Pencil 2");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Mi 10000mAh Power Bank");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Dell Laptop Sleeve 15");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "HyperDrive USB-C Hub");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Baseus Car Charger");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Ugreen USB Adapter");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Kingston 128GB Flash Drive");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Sandisk 1TB SSD");
-    recommendGraph.addEdge("Logitech G Pro Wireless Mouse", "Apple Lightning Cable");
-    recommendGraph.addEdge("Corsair K70 RGB MK.2", "Boat Type-C Cable");
-    recommendGraph.addEdge("Corsair K70 RGB MK.2", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Corsair K70 RGB MK.2", "JBL Audio Cable");
-    recommendGraph.addEdge("Corsair K70 RGB MK.2", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Corsair K70 RGB MK.2", "Apple Lightning Cable");
-    recommendGraph.addEdge("Cosmic Byte GS410 Headset", "Boat Type-C Cable");
-    recommendGraph.addEdge("Cosmic Byte GS410 Headset", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Cosmic Byte GS410 Headset", "JBL Audio Cable");
-    recommendGraph.addEdge("Cosmic Byte GS410 Headset", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Cosmic Byte GS410 Headset", "Apple Lightning Cable");
-    recommendGraph.addEdge("Alienware Aurora R16", "Boat Type-C Cable");
-    recommendGraph.addEdge("Alienware Aurora R16", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Alienware Aurora R16", "JBL Audio Cable");
-    recommendGraph.addEdge("Alienware Aurora R16", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Alienware Aurora R16", "Apple Lightning Cable");
-    recommendGraph.addEdge("Razer Kraken V3", "Boat Type-C Cable");
-    recommendGraph.addEdge("Razer Kraken V3", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Razer Kraken V3", "JBL Audio Cable");
-    recommendGraph.addEdge("Razer Kraken V3", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Razer Kraken V3", "Apple Lightning Cable");
-    recommendGraph.addEdge("Asus TUF Gaming Monitor 27", "Boat Type-C Cable");
-    recommendGraph.addEdge("Asus TUF Gaming Monitor 27", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Asus TUF Gaming Monitor 27", "JBL Audio Cable");
-    recommendGraph.addEdge("Asus TUF Gaming Monitor 27", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Asus TUF Gaming Monitor 27", "Apple Lightning Cable");
-    recommendGraph.addEdge("Logitech G923 Racing Wheel", "Boat Type-C Cable");
-    recommendGraph.addEdge("Logitech G923 Racing Wheel", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Logitech G923 Racing Wheel", "JBL Audio Cable");
-    recommendGraph.addEdge("Logitech G923 Racing Wheel", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Logitech G923 Racing Wheel", "Apple Lightning Cable");
-    recommendGraph.addEdge("HyperX Cloud Alpha", "Boat Type-C Cable");
-    recommendGraph.addEdge("HyperX Cloud Alpha", "Belkin HDMI Cable");
-    recommendGraph.addEdge("HyperX Cloud Alpha", "JBL Audio Cable");
-    recommendGraph.addEdge("HyperX Cloud Alpha", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("HyperX Cloud Alpha", "Apple Lightning Cable");
-    recommendGraph.addEdge("MSI Katana GF66 Laptop", "Boat Type-C Cable");
-    recommendGraph.addEdge("MSI Katana GF66 Laptop", "Belkin HDMI Cable");
-    recommendGraph.addEdge("MSI Katana GF66 Laptop", "JBL Audio Cable");
-    recommendGraph.addEdge("MSI Katana GF66 Laptop", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("MSI Katana GF66 Laptop", "Apple Lightning Cable");
-    recommendGraph.addEdge("Acer Nitro 5 Laptop", "Boat Type-C Cable");
-    recommendGraph.addEdge("Acer Nitro 5 Laptop", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Acer Nitro 5 Laptop", "JBL Audio Cable");
-    recommendGraph.addEdge("Acer Nitro 5 Laptop", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Acer Nitro 5 Laptop", "Apple Lightning Cable");
-    recommendGraph.addEdge("Zotac RTX 4070 GPU", "Boat Type-C Cable");
-    recommendGraph.addEdge("Zotac RTX 4070 GPU", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Zotac RTX 4070 GPU", "JBL Audio Cable");
-    recommendGraph.addEdge("Zotac RTX 4070 GPU", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Zotac RTX 4070 GPU", "Apple Lightning Cable");
-    recommendGraph.addEdge("Razer Seiren Mini Mic", "Boat Type-C Cable");
-    recommendGraph.addEdge("Razer Seiren Mini Mic", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Razer Seiren Mini Mic", "JBL Audio Cable");
-    recommendGraph.addEdge("Razer Seiren Mini Mic", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Razer Seiren Mini Mic", "Apple Lightning Cable");
-    recommendGraph.addEdge("Elgato Stream Deck", "Boat Type-C Cable");
-    recommendGraph.addEdge("Elgato Stream Deck", "Belkin HDMI Cable");
-    recommendGraph.addEdge("Elgato Stream Deck", "JBL Audio Cable");
-    recommendGraph.addEdge("Elgato Stream Deck", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("Elgato Stream Deck", "Apple Lightning Cable");
-    recommendGraph.addEdge("BenQ Zowie XL2546K", "Boat Type-C Cable");
-    recommendGraph.addEdge("BenQ Zowie XL2546K", "Belkin HDMI Cable");
-    recommendGraph.addEdge("BenQ Zowie XL2546K", "JBL Audio Cable");
-    recommendGraph.addEdge("BenQ Zowie XL2546K", "Logitech Mouse Pad XL");
-    recommendGraph.addEdge("BenQ Zowie XL2546K", "Apple Lightning Cable");
-    recommendGraph.addEdge("Apple Watch Ultra 2", "Apple MagSafe Charger");
-    recommendGraph.addEdge("Apple Watch Ultra 2", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple Watch Ultra 2", "Apple Lightning Cable");
-    recommendGraph.addEdge("Samsung Galaxy Fit 3", "Samsung 340L Refrigerator");
-    recommendGraph.addEdge("Samsung Galaxy Fit 3", "Samsung Microwave 28L");
-    recommendGraph.addEdge("Samsung Galaxy Fit 3", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung Galaxy Fit 3", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Dyson Air Purifier HP07", "HP USB-C Dock");
-    recommendGraph.addEdge("Samsung 340L Refrigerator", "Samsung Microwave 28L");
-    recommendGraph.addEdge("Samsung 340L Refrigerator", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung 340L Refrigerator", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Samsung Microwave 28L", "Samsung 45W Charger");
-    recommendGraph.addEdge("Samsung Microwave 28L", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple MagSafe Charger", "Apple Pencil 2");
-    recommendGraph.addEdge("Apple MagSafe Charger", "Apple Lightning Cable");
-    recommendGraph.addEdge("Samsung 45W Charger", "Samsung Stylus S Pen");
-    recommendGraph.addEdge("Apple Pencil 2", "Apple Lightning Cable");
+//positive integer option, fallback when missing or invalid
+size_t optionCount(const map<string, string> &opts, const string &key, size_t fallback) {
+    auto it = opts.find(key);
+    if (it == opts.end()) return fallback;
+    try {
+        long long v = stoll(it->second);
+        return v > 0 ? static_cast<size_t>(v) : fallback;
+    } catch (...) {
+        return fallback;
+    }
 }
 
-//printing products with same category
-void listCategoryProducts(const string &category) {
-    vector<Product> all = productManager.getAllProducts();
-    cout << "CATEGORY_PRODUCTS\n";
-
-    for (const auto &p : all) {
-        if (p.category == category) {
-            cout << p.name << "|" << p.price << "|" << p.stock 
-                 << "|" << p.category << "|" << p.brand << "\n";
-        }
+
+const string SNAPSHOT_FILE = "catalog.snap";
+const string TEXT_CATALOG_FILE = "products.txt";
+const string BINARY_CATALOG_FILE = "products.cat";
+const string STOCK_JOURNAL_FILE = "stock_journal.txt";
+const string RECOMMENDATIONS_FILE = "recommendations.txt";    //product1|product2 co-purchase pairs
+const string COPURCHASE_FILE = "copurchase.txt";    //weights learned from checkouts
+
+//products.cat is used when it is newer than products.txt. checkouts only append to the stock journal;
+//its compaction rewrites whichever file was loaded, so that one stays the newer
+string chooseCatalogFile(FileStamp& stamp) {
+    FileStamp text, binary;
+    bool hasText = getFileStamp(TEXT_CATALOG_FILE, text);
+    if (getFileStamp(BINARY_CATALOG_FILE, binary) && (!hasText || binary.mtime > text.mtime)) {
+        stamp = binary;
+        return BINARY_CATALOG_FILE;
+    }
+    stamp = text;
+    return TEXT_CATALOG_FILE;
+}
+
+//--import-catalog in.txt out.cat / --export-catalog in.cat out.txt, either input format is accepted
+int convertCatalog(const string& mode, const string& from, const string& to) {
+    ProductManager pm;
+    if (!pm.loadProducts(from)) {
+        cerr << "ERROR: Cannot read catalog " << from << "\n";
+        return 1;
     }
+    bool ok = mode == "--import-catalog" ? pm.saveCatalogFile(to) : pm.saveProductsToFile(to);
+    if (!ok) {
+        cerr << "ERROR: Cannot write catalog " << to << "\n";
+        return 1;
+    }
+    cerr << pm.size() << " products written to " << to << "\n";
+    return 0;
+}
 
-    cout << "CATEGORY_PRODUCTS_END\n";
+//trie ranking scores for one product, higher ranks first
+void setTrieScores(const Product &p) {
+    uint32_t id = searchTrie.findWord(p.name);
+    if (id == TRIE_NONE) return;
+    searchTrie.setScore(id, RANK_STOCK, p.stock);
+    searchTrie.setScore(id, RANK_PRICE_LOW, -p.price);
 }
 
-//fuzzy search (Levenshtein distance)
-int editDistance(const string &a, const string &b) {
-    int n = a.size(), m = b.size();
-    vector<vector<int>> dp(n + 1, vector<int>(m + 1));
-
-    for (int i = 0; i <= n; i++) dp[i][0] = i;
-    for (int j = 0; j <= m; j++) dp[0][j] = j;
-    
-    for (int i = 1; i <= n; i++) {
-        for (int j = 1; j <= m; j++) {
-            if (a[i - 1] == b[j - 1])
-                dp[i][j] = dp[i - 1][j - 1];
-            else
-                dp[i][j] = 1 + min({dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1]});
+void initializeSystem() {    //loading all the products,cart data,build trie,and build recommendation graph
+    setWorkingDirectory();
+    recommendGraph.attach(productManager);    //edges are given by name, stored by id
+    searchTrie.attach(productManager);    //the trie holds ids, names stay in the catalog
+
+    SnapshotSource source;
+    string catalogFile = chooseCatalogFile(source.products);
+    getFileStamp(RECOMMENDATIONS_FILE, source.edges);
+
+    //fast path: map the snapshot written by an earlier run
+    if (!loadSnapshot(SNAPSHOT_FILE, source, productManager, searchTrie, recommendGraph)) {
+        searchTrie.clear();
+        recommendGraph.clear();
+        productManager.loadProducts(catalogFile);
+
+        //autocomplete trie
+        for (const Product &product : productManager.view()) {
+            searchTrie.insert(product.id);
+            setTrieScores(product);
         }
+
+        recommendGraph.loadRecommendations(RECOMMENDATIONS_FILE);    //sorted, deduped, packed in one pass
+        saveSnapshot(SNAPSHOT_FILE, source, productManager, searchTrie, recommendGraph);
     }
-    return dp[n][m];
+
+    recommendGraph.loadLearned(COPURCHASE_FILE);    //changes with every checkout, so not part of the snapshot
+
+    //checkouts since the last compaction; after the snapshot so it keeps matching the catalog file
+    for (uint32_t id : stockJournal.open(STOCK_JOURNAL_FILE, catalogFile))
+        setTrieScores(*productManager.getProduct(id));
+
+    searchIndex.build(productManager.getAllProductRefs());    //word BK-tree + trigram postings
+    cart.loadFromFile();    //restore cart state
 }
 
-// Search products inside a category using fuzzy matching
-void searchCategoryProducts(const string &category, const string &query) {
-    vector<Product> all = productManager.getAllProducts();
-    string q = query;
-    transform(q.begin(), q.end(), q.begin(), ::tolower);
+//one product row in the name|price|stock|category|brand format
+void printProductRow(const Product &p) {
+    cout << p.name << "|" << p.price << "|" << p.stock 
+         << "|" << productManager.categoryName(p) << "|" << productManager.brandName(p) << "\n";
 
-    vector<Product> results;
+    //server mode: push rows out in chunks so the client can render the first ones early
+    if (serverMode && ++rowsSinceFlush >= STREAM_CHUNK_ROWS) {
+        cout.flush();
+        rowsSinceFlush = 0;
+    }
+}
 
-    for (const auto &p : all) {
-        if (p.category != category) continue;
+//opaque continuation token, today just the hex offset of the next page
+string encodeCursor(size_t offset) {
+    stringstream ss;
+    ss << "c" << hex << offset;
+    return ss.str();
+}
 
-        string name = p.name;
-        transform(name.begin(), name.end(), name.begin(), ::tolower);
+//paging for list commands: "|offset=N;limit=N" or "|cursor=TOKEN;limit=N", default is everything
+PageRequest parsePageRequest(const map<string, string> &opts) {
+    PageRequest page;
+    page.limit = optionCount(opts, "limit", SIZE_MAX);
 
-        stringstream ss(name);
-        string word;
-        bool fuzzy = false;
+    auto cursor = opts.find("cursor");
+    if (cursor != opts.end() && cursor->second.size() > 1 && cursor->second[0] == 'c') {
+        try { page.offset = stoull(cursor->second.substr(1), nullptr, 16); } catch (...) {}
+    } else {
+        page.offset = optionCount(opts, "offset", 0);
+    }
+    return page;
+}
 
-        while (ss >> word) {
-            int dist = editDistance(word, q);
-            if (dist <= 2) { 
-                fuzzy = true;
-                break;
-            }
-        }
+//trailer after a list: PAGE|offset|count|total|next cursor ('-' on the last page)
+void printPageInfo(const PageRequest &page, size_t count, size_t total) {
+    size_t next = page.offset + count;
+    cout << "PAGE|" << page.offset << "|" << count << "|" << total << "|"
+         << (count > 0 && next < total ? encodeCursor(next) : "-") << "\n";
+}
 
-        //exact or fuzzy
-        if (name.find(q) != string::npos || fuzzy) {
-            results.push_back(p);
-        }
+//same for a lazy range that stopped at the end of the page: the total is unknown ('-')
+void printOpenPageInfo(const PageRequest &page, size_t count, bool more) {
+    cout << "PAGE|" << page.offset << "|" << count << "|-|"
+         << (more ? encodeCursor(page.offset + count) : "-") << "\n";
+}
+
+//print the requested page of a view between header and footer lines
+void printPagedList(const string &header, const string &footer, const PageRequest &page, ProductView all) {
+    ProductView rows = all.page(page.offset, page.limit);
+
+    cout << header << "\n";
+    for (const Product &p : rows) printProductRow(p);
+    cout << footer << "\n";
+    printPageInfo(page, rows.size(), all.size());
+}
+
+//search results: NO_RESULTS when empty, otherwise a page of the view with its O(1) total
+void printResultPage(const string &header, const string &footer, const PageRequest &page, ProductView results) {
+    if (results.size() == 0) {
+        cout << "NO_RESULTS\n";
+        printPageInfo(page, 0, 0);
+        return;
     }
+    printPagedList(header, footer, page, results);
+}
 
-    if (results.empty()) {
+//same for a lazy range: the walk stops one row past the page instead of counting the rest
+template <typename Range>
+void printResultPage(const string &header, const string &footer, const PageRequest &page, const Range &results) {
+    if (results.begin() == results.end()) {
         cout << "NO_RESULTS\n";
+        printPageInfo(page, 0, 0);
         return;
     }
 
-    //print matched items
-    cout << "CATEGORY_SEARCH_RESULTS\n";
-    for (const auto &p : results) {
-        cout << p.name << "|" << p.price << "|" << p.stock 
-             << "|" << p.category << "|" << p.brand << "\n";
+    cout << header << "\n";
+    size_t skipped = 0, count = 0;
+    bool more = false;
+    for (const Product &p : results) {
+        if (skipped < page.offset) {
+            skipped++;
+            continue;
+        }
+        if (count == page.limit) {
+            more = true;
+            break;
+        }
+        printProductRow(p);
+        count++;
     }
-    cout << "CATEGORY_SEARCH_END\n";
+    cout << footer << "\n";
+    printOpenPageInfo(page, count, more);
+}
+
+//printing products with same category
+void listCategoryProducts(const string &category, const PageRequest &page) {
+    printPagedList("CATEGORY_PRODUCTS", "CATEGORY_PRODUCTS_END", page, productManager.view(SORT_NONE, category));
+}
+
+// Search products inside a category using fuzzy matching
+void searchCategoryProducts(const string &category, const string &query, const PageRequest &page) {
+    vector<const Product*> matches = searchIndex.search(query);
+    uint32_t categoryId = productManager.categoryIdOf(category);
+
+    //print matched items, the category check runs while printing
+    auto inCategory = ProductView(matches).where([categoryId](const Product &p) { return p.categoryId == categoryId; });
+    printResultPage("CATEGORY_SEARCH_RESULTS", "CATEGORY_SEARCH_END", page, inCategory);
 }
 
 
@@ -792,14 +327,23 @@ void processCommand(const string &command) {
         getline(ss, prefix);
         if (!prefix.empty() && prefix[0] == ' ') prefix.erase(0, 1);
 
-        vector<string> results = searchTrie.autocomplete(prefix);
+        //optional "|limit=N;rank=name|stock|price"
+        map<string, string> opts = splitCommandOptions(prefix);
+        //capped at the per-prefix cache size, so a large limit cannot walk a whole subtree
+        size_t limit = min(optionCount(opts, "limit", DEFAULT_AUTOCOMP_LIMIT), kCachedCompletions);
+
+        RankKey rank = RANK_NAME;
+        if (opts["rank"] == "stock") rank = RANK_STOCK;
+        else if (opts["rank"] == "price") rank = RANK_PRICE_LOW;
+
+        vector<uint32_t> results = searchTrie.topCompletions(prefix, limit, rank);
 
         if (results.empty()) {
             cout << "NO_AUTOCOMP" << endl;
         } else {
             cout << "AUTOCOMP_RESULTS" << endl;
-            for (const string &name : results) {
-                cout << name << endl;
+            for (uint32_t id : results) {
+                cout << searchTrie.word(id) << endl;
             }
             cout << "AUTOCOMP_END" << endl;
         }
@@ -811,43 +355,11 @@ void processCommand(const string &command) {
         getline(ss, query);
         if (!query.empty() && query[0] == ' ') query.erase(0, 1);
 
-        string lower = query;
-        transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-
-        vector<Product> all = productManager.getAllProducts();
-
-        bool found = false;
-        cout << "SEARCH_RESULTS\n";
-
-        for (const auto &p : all) {
-            string nameLower = p.name;
-            transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
-
-            // Split into words
-            stringstream ss2(nameLower);
-            string word;
-            bool fuzzy = false;
+        PageRequest page = parsePageRequest(splitCommandOptions(query));
 
-            while (ss2 >> word) {
-                int dist = editDistance(word, lower);
-                if (dist <= 2) {
-                    fuzzy = true;
-                    break;
-                }
-            }
-
-            if (nameLower.find(lower) != string::npos || fuzzy) {
-                cout << p.name << "|" 
-                    << p.price << "|" 
-                    << p.stock << "|" 
-                    << p.category << "|" 
-                    << p.brand << "\n";
-                found = true;
-            }
-        }
-
-        if (!found) cout << "NO_RESULTS\n";
-        else cout << "SEARCH_END\n";
+        //fuzzy (edit distance <= 2) or substring matches from the index
+        vector<const Product*> matches = searchIndex.search(query);
+        printResultPage("SEARCH_RESULTS", "SEARCH_END", page, ProductView(matches));
     }
 
     //sorting (accending,descending order)
@@ -857,6 +369,7 @@ void processCommand(const string &command) {
 
         getline(ss, category);
         if (!category.empty() && category[0] == ' ') category.erase(0,1);
+        PageRequest page = parsePageRequest(splitCommandOptions(category));
 
         SortType type = SORT_NONE;
         
@@ -866,21 +379,8 @@ void processCommand(const string &command) {
         else if (sortKey == "NAME_ASC") type = SORT_NAME_ASC;
         else if (sortKey == "STOCK_DESC") type = SORT_STOCK_DESC;
 
-        vector<Product> list;
-        
-        if (category.empty())        //choose category
-            list = productManager.getAllProducts();
-        else
-            list = productManager.getProductsByCategory(category);
-        //apply sorting
-        list = productManager.sortProducts(list, type);
-
-        cout << "SORTED_RESULTS\n";
-        for (auto &p : list) {
-            cout << p.name << "|" << p.price << "|" << p.stock 
-                 << "|" << p.category << "|" << p.brand << "\n";
-        }
-        cout << "SORTED_END\n";
+        //ready-made view, empty category means the whole catalog
+        printPagedList("SORTED_RESULTS", "SORTED_END", page, productManager.view(type, category));
     }
 
     else if (action == "SEARCHCAT") {
@@ -888,14 +388,16 @@ void processCommand(const string &command) {
         ss >> cat;
         getline(ss, q);
         if (!q.empty() && q[0] == ' ') q.erase(0,1);
-        searchCategoryProducts(cat, q);
+        PageRequest page = parsePageRequest(splitCommandOptions(q));
+        searchCategoryProducts(cat, q, page);
     }
 
     else if (action == "LISTCAT") {
         string category;
         getline(ss, category);
         if (!category.empty() && category[0] == ' ') category.erase(0,1);
-        listCategoryProducts(category);
+        PageRequest page = parsePageRequest(splitCommandOptions(category));
+        listCategoryProducts(category, page);
     }
 
     else if (action == "ADD") {    //adding product quantity
@@ -914,9 +416,9 @@ void processCommand(const string &command) {
         }
         
         //find product and add to cart
-        Product *p = productManager.getProduct(productName);
-        if (p)
-            cart.addItem(p, quantity);
+        uint32_t id = productManager.findId(productName);
+        if (id != ProductManager::NO_ID)
+            cart.addItem(id, quantity);
         else
             cout << "ERROR: Product not found\n";
     }
@@ -930,10 +432,38 @@ void processCommand(const string &command) {
 
     else if (action == "SHOWCART") {    //showcart
         cart.showCart();
+
+        //walk the co-purchase graph from everything in the cart, within a 2 ms budget
+        static vector<uint32_t> seeds;
+        static vector<ScoredProduct> suggestions;
+        seeds.clear();
+        for (const CartItem &item : cart.getItems()) seeds.push_back(item.productId);
+        cartRanker.rank(seeds, 10, suggestions);
+
+        size_t shown = 0;
+        for (const ScoredProduct &s : suggestions) {
+            const Product *p = productManager.getProduct(s.id);
+            if (p->stock <= 0) continue;    //nothing to add
+            if (shown++ == 0) cout << "SUGGESTIONS\n";
+            cout << p->name << "|" << p->price << "\n";
+            if (shown == 5) break;
+        }
+        if (shown) cout << "SUGGESTIONS_END\n";
     }
 
     else if (action == "CHECKOUT") {    //checkout cart
+        vector<CartItem> bought = cart.getItems();    //checkout empties the cart, keep the (id, qty) pairs
         cart.checkout(productManager);
+
+        if (!bought.empty() && cart.getItems().empty()) {    //went through
+            //stock changed, keep the stock ranking of autocomplete current
+            vector<uint32_t> basket;
+            for (const CartItem &item : bought) {
+                setTrieScores(*productManager.getProduct(item.productId));
+                basket.push_back(item.productId);
+            }
+            recommendGraph.recordBasket(basket);    //bought together, strengthens these pairs
+        }
     }
 
     // RECOMMEND product
@@ -942,34 +472,40 @@ void processCommand(const string &command) {
         getline(ss, productName);
         if (!productName.empty() && productName[0] == ' ') productName.erase(0,1);
 
-        vector<string> recs = recommendGraph.getRecommendations(productName);
+        const size_t maxResults = 5;
+        uint32_t id = productManager.findId(productName);
+        if (const string *cached = recommendCache.lookup(id, maxResults, recommendGraph.productRevision(id))) {
+            cout << *cached;
+            return;
+        }
+
+        static vector<ScoredProduct> recs;    //reused, the heap does not allocate after the first call
+        recommendGraph.topRecommendations(id, maxResults, recs);
 
         if (recs.empty()) {
             cout << "NO_RECOMMENDATIONS\n";
         } else {
-            cout << "RECOMMENDATIONS\n";
+            ostringstream out;    //rendered once, then served from the cache until its graph row changes
+            out << "RECOMMENDATIONS\n";
 
-             // Print product name + price if found in list
-            for (const string &r : recs) {
-                Product *p = productManager.getProduct(r);
-                if (p)
-                    cout << p->name << "|" << p->price << "\n";
+             // Print product name + price
+            for (const ScoredProduct &r : recs) {
+                const Product *p = productManager.getProduct(r.id);
+                out << p->name << "|" << p->price << "\n";
             }
 
-            cout << "RECOMMEND_END\n";
+            out << "RECOMMEND_END\n";
+            cout << out.str();
+            recommendCache.store(id, maxResults, recommendGraph.productRevision(id), out.str());
         }
     }
 
     else if (action == "LISTALL") {
-        vector<Product> all = productManager.getAllProducts();
-        cout << "ALL_PRODUCTS\n";
+        string rest;
+        getline(ss, rest);
+        PageRequest page = parsePageRequest(splitCommandOptions(rest));
 
-        for (const auto &p : all) {
-            cout << p.name << "|" << p.price << "|" << p.stock 
-                 << "|" << p.category << "|" << p.brand << "\n";
-        }
-
-        cout << "PRODUCTS_END\n";
+        printPagedList("ALL_PRODUCTS", "PRODUCTS_END", page, productManager.view());
     }
 
         //filter all products
@@ -977,21 +513,11 @@ void processCommand(const string &command) {
         string fs;
         getline(ss, fs);
         if (!fs.empty() && fs[0] == ' ') fs.erase(0,1);
+        PageRequest page = parsePageRequest(splitCommandOptions(fs));
 
         ProductFilters f = parseFilterString(fs);
-        vector<Product> all = productManager.getAllProducts();
-        vector<Product> out = productManager.applyFilters(all, f);
-
-        if (out.empty()) {
-            cout << "NO_RESULTS\n";
-        } else {
-            cout << "ALL_PRODUCTS\n";
-            for (const auto &p : out) {
-                cout << p.name << "|" << p.price << "|" << p.stock 
-                     << "|" << p.category << "|" << p.brand << "\n";
-            }
-            cout << "PRODUCTS_END\n";
-        }
+        vector<const Product*> out = productManager.filterCatalog(f);
+        printResultPage("ALL_PRODUCTS", "PRODUCTS_END", page, ProductView(out));
     }
 
     else {
@@ -999,9 +525,62 @@ void processCommand(const string &command) {
     }
 }
 
-int main() {
+//server mode: stay resident and answer framed commands over stdin/stdout
+//every input line gets exactly one response, terminated by a RESPONSE_FRAME_END line. QUIT stops the loop
+const string RESPONSE_FRAME_END = "#END";    //'#' lines are never product names
+
+void runServer() {
+    serverMode = true;
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    string command;
+    while (getline(cin, command)) {
+        if (!command.empty() && command.back() == '\r') command.pop_back();
+        if (command == "QUIT") {
+            cout << "BYE\n" << RESPONSE_FRAME_END << endl;
+            break;
+        }
+
+        //the client waits for a frame after every line it writes, so blank lines get one too
+        if (command.find_first_not_of(" \t") == string::npos) cout << "ERROR: Empty command\n";
+        else processCommand(command);
+        cout << RESPONSE_FRAME_END << endl;    //endl flushes the whole frame to the client
+    }
+
+    cart.saveToFile();    // save cart before exit
+    stockJournal.close();    //sync the last checkouts
+    recommendGraph.saveLearned(COPURCHASE_FILE);
+}
+
+int main(int argc, char *argv[]) {
+    //conversion takes exactly its two files, the other options can come in any order
+    if (argc > 1 && (string(argv[1]) == "--import-catalog" || string(argv[1]) == "--export-catalog")) {
+        if (argc != 4) {
+            cerr << "ERROR: Usage: " << argv[1] << " <from> <to>\n";
+            return 1;
+        }
+        return convertCatalog(argv[1], argv[2], argv[3]);
+    }
+
+    bool server = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--server") server = true;
+        else if (arg == "--cart-write-through") cart.setDurability(CART_WRITE_THROUGH);    //default batches cart writes
+        else {
+            cerr << "ERROR: Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
     initializeSystem();    //load everything
 
+    if (server) {
+        runServer();
+        return 0;
+    }
+
     ifstream inputFile("input.txt");
     ofstream outputFile("output.txt");
 
@@ -1024,5 +603,7 @@ int main() {
     outputFile.close();
 
     cart.saveToFile();    // save cart before exit
+    stockJournal.close();    //sync the last checkouts
+    recommendGraph.saveLearned(COPURCHASE_FILE);
     return 0;
 }
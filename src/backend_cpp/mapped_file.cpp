@@ -0,0 +1,158 @@
+//platform headers go first so windows.h is not parsed after "using namespace std"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+#include <filesystem>
+
+using namespace std;
+
+MappedFile::MappedFile() : base(nullptr), length(0) {
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mapHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string& filename) {
+    close();
+    HANDLE f = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) {
+        CloseHandle(f);
+        return false;
+    }
+
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) {
+        CloseHandle(f);
+        return false;
+    }
+
+    void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+
+    fileHandle = f;
+    mapHandle = m;
+    base = static_cast<const char*>(view);
+    length = static_cast<size_t>(sz.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) UnmapViewOfFile(base);
+    if (mapHandle) CloseHandle(mapHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    base = nullptr;
+    length = 0;
+    fileHandle = nullptr;
+    mapHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const string& filename) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    //the mapping stays valid after the descriptor is closed
+    if (view == MAP_FAILED) return false;
+
+    base = static_cast<const char*>(view);
+    length = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) munmap(const_cast<char*>(base), length);
+    base = nullptr;
+    length = 0;
+}
+
+#endif
+
+bool getFileStamp(const string& filename, FileStamp& stamp) {
+    error_code ec;
+    uintmax_t sz = filesystem::file_size(filename, ec);
+    if (ec) return false;
+    auto t = filesystem::last_write_time(filename, ec);
+    if (ec) return false;
+
+    stamp.size = sz;
+    stamp.mtime = static_cast<int64_t>(t.time_since_epoch().count());
+    return true;
+}
+
+void syncToDisk(FILE* f) {
+    fflush(f);
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+bool replaceFile(const string& filename, const string& contents, bool sync) {
+    string tmp = filename + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(contents.data(), 1, contents.size(), f) == contents.size();
+    if (sync) syncToDisk(f);
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        remove(tmp.c_str());
+        return false;
+    }
+
+    //the target is never removed first: a crash leaves the old file or the new one
+#ifdef _WIN32
+    if (!MoveFileExA(tmp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        remove(tmp.c_str());
+        return false;
+    }
+#else
+    if (rename(tmp.c_str(), filename.c_str()) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    if (sync) {    //the rename itself is only durable once the directory entry is on disk
+        filesystem::path dir = filesystem::path(filename).parent_path();
+        int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+using namespace std;
+
+//read-only memory mapping of a whole file (used for fast startup snapshots)
+class MappedFile {
+private:
+    const char* base;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mapHandle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& filename);    //map the file, false if missing or empty
+    void close();
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+//size + modification time, used to notice that a source file changed
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+
+    bool operator==(const FileStamp& o) const { return size == o.size && mtime == o.mtime; }
+    bool operator!=(const FileStamp& o) const { return !(*this == o); }
+};
+
+bool getFileStamp(const string& filename, FileStamp& stamp);    //false if the file does not exist
+
+void syncToDisk(FILE* f);    //flush stdio and the OS cache of f to the disk
+//write contents to filename.tmp and rename it over filename, so readers see the old or the new
+//file and never half of one. the target is never deleted first (MoveFileEx on windows).
+//sync = fsync the temp file before the rename and the directory after it
+bool replaceFile(const string& filename, const string& contents, bool sync);
+
+#endif
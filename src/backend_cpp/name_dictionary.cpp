@@ -0,0 +1,25 @@
+#include "name_dictionary.h"
+#include "text_normalize.h"
+
+using namespace std;
+
+uint32_t NameDictionary::intern(const string& name) {
+    auto it = ids.emplace(foldKey(name), static_cast<uint32_t>(names.size()));
+    if (it.second) names.push_back(name);
+    return it.first->second;
+}
+
+uint32_t NameDictionary::find(const string& name) const {
+    auto it = ids.find(foldKey(name));
+    return it == ids.end() ? NO_ID : it->second;
+}
+
+const string& NameDictionary::name(uint32_t id) const {
+    static const string empty;
+    return id < names.size() ? names[id] : empty;
+}
+
+void NameDictionary::clear() {
+    names.clear();
+    ids.clear();
+}
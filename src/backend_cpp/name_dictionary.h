@@ -0,0 +1,27 @@
+#ifndef NAME_DICTIONARY_H
+#define NAME_DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+//interned category / brand names: every distinct name gets a small id, names that
+//differ only in case or accents (foldKey) share one id
+class NameDictionary {
+private:
+    vector<string> names;    //id -> name as first seen
+    unordered_map<string, uint32_t> ids;    //folded name -> id
+
+public:
+    static constexpr uint32_t NO_ID = UINT32_MAX;
+
+    uint32_t intern(const string& name);    //existing id or a new one
+    uint32_t find(const string& name) const;    //NO_ID when unknown, never allocates an id
+    const string& name(uint32_t id) const;    //"" for NO_ID
+    size_t size() const { return names.size(); }
+    void clear();
+};
+
+#endif
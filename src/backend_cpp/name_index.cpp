@@ -0,0 +1,108 @@
+#include "name_index.h"
+#include "product.h"
+#include "text_normalize.h"
+
+using namespace std;
+
+//same as tolower() in the "C" locale, without the call per byte
+static inline unsigned char lowerByte(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? u + ('a' - 'A') : u;
+}
+
+static inline bool isAscii(string_view s) {
+    for (char c : s)
+        if (static_cast<unsigned char>(c) >= 0x80) return false;
+    return true;
+}
+
+//foldKey(a) == foldKey(b). on ASCII foldKey is plain lowercasing, so only names with other
+//bytes pay for building the folded copies
+static bool sameKey(string_view a, string_view b) {
+    if (a.size() == b.size()) {
+        size_t i = 0;
+        for (; i < a.size(); i++) {
+            if ((static_cast<unsigned char>(a[i]) | static_cast<unsigned char>(b[i])) >= 0x80) break;
+            if (lowerByte(a[i]) != lowerByte(b[i])) return false;
+        }
+        if (i == a.size()) return true;
+    } else if (isAscii(a) && isAscii(b)) {
+        return false;
+    }
+    return foldKey(a) == foldKey(b);
+}
+
+static uint32_t fnv1aLower(string_view bytes) {
+    uint32_t h = 2166136261u;
+    for (char c : bytes) {
+        h ^= lowerByte(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t NameIndex::foldedHash(string_view name) {
+    if (!isAscii(name)) return fnv1aLower(foldKey(name));
+    return fnv1aLower(name);
+}
+
+void NameIndex::attach(const vector<Product>& products) {
+    table = &products;
+    clear();
+}
+
+void NameIndex::clear() {
+    slots.clear();
+    used = 0;
+}
+
+size_t NameIndex::probe(string_view name, uint32_t hash) const {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot &s = slots[i];
+        if (s.id == NO_ID) return i;
+        if (s.hash == hash && sameKey((*table)[s.id].name, name)) return i;
+    }
+}
+
+void NameIndex::grow() {
+    rehash(slots.empty() ? 64 : slots.size() * 2);
+}
+
+void NameIndex::reserve(size_t n) {
+    size_t want = 64;
+    while (want < n * 2) want *= 2;
+    if (want > slots.size()) rehash(want);
+}
+
+void NameIndex::rehash(size_t size) {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(size, Slot{0, NO_ID});
+
+    size_t mask = slots.size() - 1;
+    for (const Slot &s : old) {
+        if (s.id == NO_ID) continue;
+        size_t i = s.hash & mask;
+        while (slots[i].id != NO_ID) i = (i + 1) & mask;
+        slots[i] = s;
+    }
+}
+
+uint32_t NameIndex::insert(uint32_t id) {
+    if ((used + 1) * 2 > slots.size()) grow();
+
+    const string &name = (*table)[id].name;
+    uint32_t hash = foldedHash(name);
+    Slot &s = slots[probe(name, hash)];
+    if (s.id != NO_ID) return s.id;    //one probe serves as both the duplicate check and the insert
+    used++;
+    s.hash = hash;
+    s.id = id;
+    return NO_ID;
+}
+
+uint32_t NameIndex::find(string_view name) const {
+    if (slots.empty()) return NO_ID;
+    return slots[probe(name, foldedHash(name))].id;
+}
@@ -0,0 +1,41 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+struct Product;
+
+//product name -> id table (open addressing), keyed by foldKey like the trie and the dictionaries,
+//so case and accents do not matter. the hash of the folded name is kept in the slot and names
+//are compared only on a hash hit. ASCII names are folded byte by byte without building a copy
+class NameIndex {
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;    //NO_ID marks an empty slot
+    };
+
+    vector<Slot> slots;    //size is a power of two, at most half full
+    size_t used = 0;
+    const vector<Product>* table = nullptr;    //names are read from here
+
+    void grow();
+    void rehash(size_t size);    //size is a power of two
+    size_t probe(string_view name, uint32_t hash) const;    //slot holding name, or the empty slot to use
+
+public:
+    static constexpr uint32_t NO_ID = UINT32_MAX;
+
+    static uint32_t foldedHash(string_view name);    //FNV-1a over foldKey(name)
+
+    void attach(const vector<Product>& products);    //table the ids refer to, also clears the index
+    void clear();
+    void reserve(size_t n);    //room for n names without growing
+    uint32_t insert(uint32_t id);    //adds products[id].name, or returns the id already holding that name (NO_ID if added)
+    uint32_t find(string_view name) const;    //NO_ID when unknown
+};
+
+#endif
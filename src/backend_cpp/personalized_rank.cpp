@@ -0,0 +1,97 @@
+#include "personalized_rank.h"
+#include <algorithm>
+
+void PersonalizedRanker::addResidual(uint32_t node, float mass) {
+    NodeState& s = state[node];
+    if (s.estimate == 0.0f && s.residual == 0.0f) touched.push_back(node);
+    s.residual += mass;
+    if (!s.queued && s.residual > PPR_EPSILON) {
+        s.queued = 1;
+        frontier.push_back(node);
+    }
+}
+
+float PersonalizedRanker::strength(uint32_t node) const {
+    Neighbors row = graph.getRecommendations(node, SIZE_MAX);
+    float total = 0.0f;
+    for (size_t i = 0; i < row.size(); i++) total += row.weight(i);
+    for (const LearnedEdge& e : graph.learnedOf(node)) total += graph.decayed(e);
+    return total;
+}
+
+//settle alpha of the node's residual and spread the rest over its neighbours by edge weight.
+//file and learned edges both count, a pair present in both gets the sum
+void PersonalizedRanker::push(uint32_t node) {
+    NodeState& s = state[node];
+    float mass = s.residual;
+    s.residual = 0.0f;
+    Neighbors row = graph.getRecommendations(node, SIZE_MAX);
+    const vector<LearnedEdge>& mine = graph.learnedOf(node);
+
+    float total = strength(node);
+    s.degree = total;
+    if (total <= 0.0f) {    //dead end: the walk can only restart, keep everything here
+        s.estimate += mass;
+        return;
+    }
+
+    s.estimate += PPR_RESTART * mass;
+    float share = (1.0f - PPR_RESTART) * mass / total;
+    for (size_t i = 0; i < row.size(); i++) addResidual(row[i], share * row.weight(i));
+    for (const LearnedEdge& e : mine) addResidual(e.id, share * graph.decayed(e));
+}
+
+//a is the better suggestion: higher score, or the same score and a lower id
+static inline bool better(const ScoredProduct& a, const ScoredProduct& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.id < b.id;
+}
+
+void PersonalizedRanker::rank(const vector<uint32_t>& seeds, size_t k, vector<ScoredProduct>& out,
+                              chrono::microseconds budget) {
+    out.clear();
+    pushes = 0;
+    size_t n = graph.nodeCount();
+    if (k == 0 || n == 0) return;
+    if (state.size() < n) state.resize(n);    //only grows when the catalog does
+
+    size_t usable = 0;
+    for (uint32_t s : seeds) if (s < n) usable++;
+    if (usable == 0) return;
+    for (uint32_t s : seeds) if (s < n) addResidual(s, 1.0f / usable);
+
+    //FIFO push until every residual is below epsilon or the budget runs out.
+    //the clock is read every 16 pushes, a push costs about a microsecond on a cold graph
+    auto deadline = chrono::steady_clock::now() + budget;
+    size_t head = 0;
+    while (head < frontier.size() && pushes < PPR_MAX_PUSHES) {
+        uint32_t node = frontier[head++];
+        state[node].queued = 0;
+        if (state[node].residual <= PPR_EPSILON) continue;
+        push(node);
+        if (++pushes % 16 == 0 && chrono::steady_clock::now() >= deadline) break;
+    }
+
+    //best k touched nodes by estimate / weighted degree, bounded min-heap on better. raw PageRank
+    //mass grows with degree, so without this the accessories paired with everything win every cart
+    for (uint32_t node : touched) {
+        const NodeState& s = state[node];
+        if (s.estimate <= 0.0f) continue;    //reached but never pushed
+        if (find(seeds.begin(), seeds.end(), node) != seeds.end()) continue;
+        ScoredProduct c{node, s.degree > 0.0f ? s.estimate / s.degree : s.estimate, node};
+        if (out.size() < k) {
+            out.push_back(c);
+            push_heap(out.begin(), out.end(), better);
+        } else if (better(c, out.front())) {
+            pop_heap(out.begin(), out.end(), better);
+            out.back() = c;
+            push_heap(out.begin(), out.end(), better);
+        }
+    }
+    sort_heap(out.begin(), out.end(), better);    //best first
+
+    //sparse reset, the state is all zero again for the next query
+    for (uint32_t node : touched) state[node] = NodeState();
+    touched.clear();
+    frontier.clear();
+}
@@ -0,0 +1,48 @@
+#ifndef PERSONALIZED_RANK_H
+#define PERSONALIZED_RANK_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "graph.h"
+using namespace std;
+
+const float PPR_RESTART = 0.15f;    //chance the walk jumps back to the cart at each step
+const float PPR_EPSILON = 1e-4f;    //residual mass below this is not pushed any further
+const int PPR_BUDGET_US = 2000;    //answer within 2 ms, whatever the graph size
+const size_t PPR_MAX_PUSHES = 100000;
+
+//"complete your cart" ranking: personalized PageRank over the co-purchase graph, with the cart
+//as restart set, computed by forward push (Andersen-Chung-Lang). only nodes that received mass
+//are touched, and the per-node state is allocated once and cleared sparsely after each query
+class PersonalizedRanker {
+private:
+    //everything a push reads or writes for one node, 16 bytes so a node costs one cache miss
+    struct NodeState {
+        float estimate = 0.0f;    //PageRank mass settled here
+        float residual = 0.0f;    //mass still waiting to be pushed
+        float degree = 0.0f;    //weighted degree, noted when the node is pushed
+        uint32_t queued = 0;
+    };
+
+    const RecommendationGraph& graph;
+    vector<NodeState> state;    //indexed by product id, all zero between queries
+    vector<uint32_t> touched;    //nodes with nonzero state, for the sparse reset
+    vector<uint32_t> frontier;    //FIFO of nodes to push
+    size_t pushes = 0;
+
+    float strength(uint32_t node) const;    //weighted degree, file plus decayed learned edges
+    void addResidual(uint32_t node, float mass);
+    void push(uint32_t node);
+
+public:
+    explicit PersonalizedRanker(const RecommendationGraph& g) : graph(g) {}
+
+    //best k products for the seed set, seeds themselves excluded, best first. stops pushing once
+    //the budget is used up, the scores found so far are still a valid (coarser) ranking
+    void rank(const vector<uint32_t>& seeds, size_t k, vector<ScoredProduct>& out,
+              chrono::microseconds budget = chrono::microseconds(PPR_BUDGET_US));
+    size_t lastPushes() const { return pushes; }    //work done by the last rank()
+};
+
+#endif
@@ -1,4 +1,9 @@
 #include "product.h"
+#include "snapshot.h"
+#include "sort_engine.h"
+#include "catalog_parser.h"
+#include "catalog_file.h"
+#include "mapped_file.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -7,196 +12,289 @@
 
 using namespace std;
 
-//string trim function
-static inline string trim(const string &s) {
-    size_t a = s.find_first_not_of(" \t\r\n");
-    if (a == string::npos) return "";
-    size_t b = s.find_last_not_of(" \t\r\n");
-    return s.substr(a, b - a + 1);
-}
-
-//loading products from .txt and storing in the map
-void ProductManager::loadProducts(const string& filename) {
+//loading products from products.txt or a binary catalog, ids follow the file order
+bool ProductManager::loadProducts(const string& filename) {
     products.clear();
-    ifstream in(filename);
-    if (!in.is_open()) return;
-
-    string line;
-    while (getline(in, line)) {
-        if (line.empty()) continue;    //skip blanks
-        if (line[0] == '#') continue;    //skip comments
+    nameIndex.clear();
+    categories.clear();
+    brands.clear();
+
+    MappedFile file;
+    bool ok = file.open(filename);    //false if missing or empty
+    if (ok && isCatalogFile(file.data(), file.size())) {
+        ok = readCatalogFile(file.data(), file.size());
+    } else if (ok) {
+        readTextCatalog(file.data(), file.size());
+    }
 
-        vector<string> parts;
-        string tmp;
-        stringstream ss(line);
-        while (getline(ss, tmp, '|')) parts.push_back(trim(tmp));    //split line using '|'
-        if (parts.size() < 4) continue;
+    buildSortedViews();    //also drops views into a cleared table
+    return ok;
+}
 
+void ProductManager::readTextCatalog(const char* data, size_t size) {
+    //fields are views into the mapping, only names are copied out
+    vector<CatalogRow> rows = parseCatalog(data, size);
+    products.reserve(rows.size());
+    nameIndex.reserve(rows.size());
+
+    //most lines repeat a few category/brand spellings, fold each spelling once
+    unordered_map<string_view, uint32_t> categoryIds, brandIds;
+    auto internCached = [](unordered_map<string_view, uint32_t>& cache, NameDictionary& dict, string_view name) {
+        auto it = cache.find(name);
+        if (it != cache.end()) return it->second;
+        uint32_t id = dict.intern(string(name));
+        cache.emplace(name, id);
+        return id;
+    };
+
+    for (const CatalogRow &row : rows) {
         Product p;
-        p.name = parts[0];
-
-        try { p.price = stod(parts[1]); } catch (...) { p.price = 0.0; }
-        try { p.stock = stoi(parts[2]); } catch (...) { p.stock = 0; }
-
-        p.category = (parts.size() > 3 ? parts[3] : "");
-        p.brand = (parts.size() > 4 ? parts[4] : "");
+        p.name.assign(row.name);
+        p.price = row.price;
+        p.stock = row.stock;
+        p.categoryId = internCached(categoryIds, categories, row.category);
+        p.brandId = internCached(brandIds, brands, row.brand);
+
+        p.id = static_cast<uint32_t>(products.size());
+        products.push_back(move(p));
+
+        //a repeated name (ignoring case) replaces the earlier line but keeps its id
+        uint32_t earlier = nameIndex.insert(products.back().id);
+        if (earlier != NO_ID) {
+            products.back().id = earlier;
+            products[earlier] = move(products.back());
+            products.pop_back();
+        }
+    }
+}
 
-        string key = p.name;    // Lowercase key for consistent lookups
-        transform(key.begin(), key.end(), key.begin(), ::tolower);
+//binary catalog: columns are copied straight out of the mapping, nothing is parsed
+bool ProductManager::readCatalogFile(const char* data, size_t size) {
+    CatalogFileReader in;
+    bool ok = in.open(data, size);
+
+    //dictionary ids must come back as stored, a clash means the file was not written by us
+    for (uint32_t i = 0; ok && i < in.categoryCount(); i++)
+        ok = categories.intern(string(in.categoryName(i))) == i;
+    for (uint32_t i = 0; ok && i < in.brandCount(); i++)
+        ok = brands.intern(string(in.brandName(i))) == i;
+
+    products.resize(ok ? in.productCount() : 0);
+    nameIndex.reserve(products.size());
+    for (uint32_t i = 0; ok && i < products.size(); i++) {
+        Product &p = products[i];
+        p.id = i;
+        p.name.assign(in.name(i));
+        p.price = in.price(i);
+        p.stock = in.stock(i);
+        p.categoryId = in.categoryId(i);
+        p.brandId = in.brandId(i);
+        ok = p.categoryId < categories.size() && p.brandId < brands.size() && nameIndex.insert(i) == NO_ID;
+    }
 
-        products[key] = p;
+    if (!ok) {    //corrupt, leave an empty catalog rather than half of one
+        products.clear();
+        nameIndex.clear();
+        categories.clear();
+        brands.clear();
     }
-    in.close();
+    return ok;
 }
 
-// Save product list back to a file
-void ProductManager::saveProductsToFile(const string& filename) {
-    ofstream out(filename);
-    if (!out.is_open()) return;
+//binary columnar copy of the catalog, see catalog_file.h
+string ProductManager::catalogFileBytes() const {
+    CatalogFileWriter out;
+    for (uint32_t i = 0; i < categories.size(); i++) out.addCategory(categories.name(i));
+    for (uint32_t i = 0; i < brands.size(); i++) out.addBrand(brands.name(i));
+    for (const Product &p : products) out.addProduct(p.name, p.price, p.stock, p.categoryId, p.brandId);
+    return out.serialize();
+}
 
-    // Write products back in the same format
-    for (auto &pr : products) {
-        const Product &p = pr.second;
+// Product list in the products.txt format and order
+string ProductManager::textCatalogBytes() const {
+    ostringstream out;
+    for (const Product &p : products) {
         out << p.name << "|" << p.price << "|" << p.stock << "|"
-            << p.category << "|" << p.brand << "\n";
+            << categoryName(p) << "|" << brandName(p) << "\n";
     }
-    out.close();
+    return out.str();
 }
 
-Product* ProductManager::getProduct(const string& name) {
-    string key = name;
-    transform(key.begin(), key.end(), key.begin(), ::tolower);
+bool ProductManager::saveCatalogFile(const string& filename) const {
+    return replaceFile(filename, catalogFileBytes(), false);
+}
 
-    auto it = products.find(key);
-    if (it == products.end()) return nullptr;
+// Save product list back to a file
+bool ProductManager::saveProductsToFile(const string& filename) {
+    return replaceFile(filename, textCatalogBytes(), false);
+}
 
-    return &it->second;
+Product* ProductManager::getProduct(const string& name) {
+    return getProduct(nameIndex.find(name));
 }
 
-// Return all products as a vector
-vector<Product> ProductManager::getAllProducts() {
-    vector<Product> v;
+// Return pointers to all products without copying them
+vector<const Product*> ProductManager::getAllProductRefs() const {
+    vector<const Product*> v;
     v.reserve(products.size());
 
-    for (auto &pr : products)
-        v.push_back(pr.second);
+    for (const Product &p : products)
+        v.push_back(&p);
 
     return v;
 }
 
-// Return all products that match the category
-vector<Product> ProductManager::getProductsByCategory(const string& category) {
-    vector<Product> result;
-    string catLower = category;
+//update product stock
+bool ProductManager::updateStock(uint32_t id, int quantity) {
+    if (id >= products.size()) return false;
+    Product &p = products[id];
 
-    transform(catLower.begin(), catLower.end(), catLower.begin(), ::tolower);
+    if (p.stock + quantity < 0) return false;    //keeping stock number non negative
 
-    for (auto &pr : products) {
-        string pcatLower = pr.second.category;
-        transform(pcatLower.begin(), pcatLower.end(), pcatLower.begin(), ::tolower);
+    int oldStock = p.stock;
+    p.stock += quantity;
 
-        if (pcatLower == catLower)
-            result.push_back(pr.second);
-    }
-    return result;
+    //only the stock ordered views move, and only between the old and new position
+    repositionStock(allViews.order[SORT_STOCK_DESC], &p, oldStock);
+
+    if (p.categoryId < categoryViews.size())
+        repositionStock(categoryViews[p.categoryId].order[SORT_STOCK_DESC], &p, oldStock);
+    return true;
 }
 
-//update product stock
 bool ProductManager::updateStock(const string& name, int quantity) {
-    string key = name;
-    transform(key.begin(), key.end(), key.begin(), ::tolower);
-
-    auto it = products.find(key);
-    if (it == products.end()) return false;
-
-    if (it->second.stock + quantity < 0) return false;    //keeping stock number non negative
-
-    it->second.stock += quantity;
-    return true;
+    return updateStock(nameIndex.find(name), quantity);
 }
 
 void ProductManager::displayProduct(const Product& p) {
     cout << p.name << "|" << p.price << "|" << p.stock << "|"
-         << p.category << "|" << p.brand << endl;
-}
-
-//applying filters (price,category,brand)
-vector<Product> ProductManager::applyFilters(const vector<Product>& input, const ProductFilters& f) {
-    vector<Product> out;
-    out.reserve(input.size());
-
-    for (const Product &p : input) {
-        //price filters
-        if (f.min_price >= 0.0 && p.price < f.min_price) continue;
-        if (f.max_price >= 0.0 && p.price > f.max_price) continue;
-
-        //category filters
-        if (!f.category.empty()) {
-            string a = p.category;
-            string b = f.category;
-            transform(a.begin(), a.end(), a.begin(), ::tolower);
-            transform(b.begin(), b.end(), b.begin(), ::tolower);
-            if (a != b) continue;
-        }
-
-        //brand filters
-        if (!f.brands.empty()) {
-            bool ok = false;
+         << categoryName(p) << "|" << brandName(p) << endl;
+}
 
-            string pbrand = p.brand;
-            transform(pbrand.begin(), pbrand.end(), pbrand.begin(), ::tolower);
+//filters the whole catalog through the posting lists or the filter columns, results in catalog order
+vector<const Product*> ProductManager::filterCatalog(const ProductFilters& f) const {
+    return columns.filter(f);
+}
 
-            for (const string &b : f.brands) {
-                string lb = b;
-                transform(lb.begin(), lb.end(), lb.begin(), ::tolower);
+static void fillViews(vector<const Product*> (&order)[SORT_TYPE_COUNT], const vector<const Product*>& items) {
+    for (int t = 0; t < SORT_TYPE_COUNT; t++) {
+        vector<uint32_t> perm = sortPermutation(items, sortKeysFor(SortType(t)));
+        order[t].clear();
+        order[t].reserve(items.size());
+        for (uint32_t i : perm) order[t].push_back(items[i]);
+    }
+}
 
-                if (lb == pbrand) {
-                    ok = true;
-                    break;
-                }
-            }
-            if (!ok) continue;
-        }
+//rebuild every sorted view from scratch, done once per load
+void ProductManager::buildSortedViews() {
+    vector<const Product*> all = getAllProductRefs();
+    columns.build(all, categories, brands);    //row i is product i
 
-        out.push_back(p);
+    vector<vector<const Product*>> byCategory(categories.size());
+    for (const Product* p : all) {
+        if (p->categoryId < byCategory.size()) byCategory[p->categoryId].push_back(p);    //stays in catalog order
     }
 
-    return out;
+    fillViews(allViews.order, all);
+    categoryViews.assign(byCategory.size(), SortedViews());
+    for (size_t c = 0; c < byCategory.size(); c++) fillViews(categoryViews[c].order, byCategory[c]);
+}
+
+//move p to its new place in a stock (high to low) view, ties keep catalog order
+void ProductManager::repositionStock(vector<const Product*>& view, const Product* p, int oldStock) {
+    auto before = [&](const Product* a, int aStock, const Product* b, int bStock) {
+        if (aStock != bStock) return aStock > bStock;
+        return a->id < b->id;
+    };
+    //p itself still has to be found by its old stock
+    auto stockOf = [&](const Product* e) { return e == p ? oldStock : e->stock; };
+
+    auto oldPos = lower_bound(view.begin(), view.end(), p, [&](const Product* e, const Product* target) {
+        return before(e, stockOf(e), target, oldStock);
+    });
+    if (oldPos == view.end() || *oldPos != p) return;
+
+    auto precedes = [&](const Product* e, const Product* target) {
+        return before(e, e->stock, target, target->stock);
+    };
+
+    //shift only the products between the old and the new position
+    if (p->stock > oldStock) {
+        auto newPos = lower_bound(view.begin(), oldPos, p, precedes);
+        rotate(newPos, oldPos, oldPos + 1);
+    } else {
+        auto newPos = lower_bound(oldPos + 1, view.end(), p, precedes);
+        rotate(oldPos, oldPos + 1, newPos);
+    }
 }
 
-//sort products based on different sort types using insertion sort 
-vector<Product> ProductManager::sortProducts(vector<Product> list, SortType type) {
-    for (int i = 1; i < list.size(); i++) {
-        Product key = list[i];
-        int j = i - 1;
-        //comparision for different sort types
-        auto cmp = [&](const Product &a, const Product &b) {
-            switch (type) {
-                case SORT_PRICE_ASC:
-                    return a.price < b.price;
+ProductView ProductManager::view(SortType type, const string& category) const {
+    if (type < 0 || type >= SORT_TYPE_COUNT) type = SORT_NONE;
+    if (category.empty()) return ProductView(allViews.order[type]);
+
+    uint32_t id = categories.find(category);
+    if (id >= categoryViews.size()) return ProductView();
+    return ProductView(categoryViews[id].order[type]);    //category views double as its posting list
+}
 
-                case SORT_PRICE_DESC:
-                    return a.price > b.price;
+static void writeNames(SnapshotWriter& w, const NameDictionary& dict) {
+    w.putU32(static_cast<uint32_t>(dict.size()));
+    for (uint32_t id = 0; id < dict.size(); id++) w.putString(dict.name(id));
+}
 
-                case SORT_NAME_ASC:
-                    return a.name < b.name;
+//interning the names in id order gives every name its old id back
+static bool readNames(SnapshotReader& r, NameDictionary& dict) {
+    dict.clear();
+    uint32_t count = r.getCount(sizeof(uint32_t));    //length prefix of each name
+    for (uint32_t id = 0; id < count && r.ok(); id++) {
+        if (dict.intern(r.getString()) != id) return false;
+    }
+    return r.ok();
+}
 
-                case SORT_STOCK_DESC:
-                    return a.stock > b.stock;
+void ProductManager::writeSnapshot(SnapshotWriter& w) const {
+    writeNames(w, categories);
+    writeNames(w, brands);
+
+    //id order, so ids come back unchanged
+    w.putU32(static_cast<uint32_t>(products.size()));
+    for (const Product &p : products) {
+        w.putString(p.name);
+        w.putDouble(p.price);
+        w.putI32(p.stock);
+        w.putU32(p.categoryId);
+        w.putU32(p.brandId);
+    }
+}
 
-                default:
-                    return false;
-            }
-        };
+bool ProductManager::readSnapshot(SnapshotReader& r) {
+    NameDictionary loadedCategories, loadedBrands;
+    if (!readNames(r, loadedCategories) || !readNames(r, loadedBrands)) return false;
 
-        //standard insertion sort shift
-        while (j >= 0 && cmp(key, list[j])) {
-            list[j + 1] = list[j];
-            j--;
-        }
+    vector<Product> loaded;
+    //name length, price, stock, category, brand
+    uint32_t count = r.getCount(sizeof(uint32_t) + sizeof(double) + sizeof(int32_t) + 2 * sizeof(uint32_t));
+    loaded.reserve(count);
 
-        list[j + 1] = key;
+    for (uint32_t i = 0; i < count && r.ok(); i++) {
+        Product p;
+        p.id = i;
+        p.name = r.getString();
+        p.price = r.getDouble();
+        p.stock = r.getI32();
+        p.categoryId = r.getU32();
+        p.brandId = r.getU32();
+        if (p.categoryId >= loadedCategories.size() || p.brandId >= loadedBrands.size()) return false;
+        loaded.push_back(move(p));
     }
 
-    return list;
+    if (!r.ok()) return false;
+    products.swap(loaded);
+    categories = move(loadedCategories);
+    brands = move(loadedBrands);
+
+    nameIndex.clear();
+    for (const Product &p : products) nameIndex.insert(p.id);
+    buildSortedViews();    //derived data, cheaper to rebuild than to store
+    return true;
 }
@@ -4,18 +4,26 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <cstdint>
+#include "column_store.h"
+#include "name_dictionary.h"
+#include "product_view.h"
+#include "name_index.h"
 using namespace std;
 
+class SnapshotWriter;
+class SnapshotReader;
+
 //all product info
 struct Product {
-    string id;
+    uint32_t id;    //dense, position in the catalog (file order), assigned at load
     string name;
     double price;
     int stock;
-    string category;    //electronics,home,audio etc
-    string brand;
+    uint32_t categoryId;    //electronics,home,audio etc, see ProductManager::categoryName
+    uint32_t brandId;
 
-    Product() : price(0.0), stock(0) {}
+    Product() : id(0), price(0.0), stock(0), categoryId(NameDictionary::NO_ID), brandId(NameDictionary::NO_ID) {}
 };
 
 //filters applied during searching
@@ -26,35 +34,77 @@ struct ProductFilters {
     string category = "";
 };
 
-// Insertion Sort
+// Sort orders offered to the GUI (see sort_engine.h)
 enum SortType {
     SORT_NONE,
     SORT_PRICE_ASC,      // Price (Low → High)
     SORT_PRICE_DESC,     // Price (High → Low)
     SORT_NAME_ASC,       // Name (A → Z)
-    SORT_STOCK_DESC      // Stock (High → Low)
+    SORT_STOCK_DESC,     // Stock (High → Low)
+    SORT_TYPE_COUNT
 };
 
 class ProductManager {
 private:
-    unordered_map<string, Product> products;    //stores all products using lowercase name as key
+    vector<Product> products;    //indexed by Product::id, never resized between loads
+    NameIndex nameIndex;    //folded (foldKey) name -> id, same keys as the trie
+    NameDictionary categories;    //category id <-> name, filled at load
+    NameDictionary brands;
+
+    //one ready-made order per SortType, for the whole catalog and for each category
+    struct SortedViews {
+        vector<const Product*> order[SORT_TYPE_COUNT];
+    };
+    SortedViews allViews;
+    vector<SortedViews> categoryViews;    //indexed by category id
+    ProductColumns columns;    //filter columns, row = product id
+
+    void buildSortedViews();
+    void readTextCatalog(const char* data, size_t size);
+    bool readCatalogFile(const char* data, size_t size);    //false if corrupt, leaves the catalog empty
+    void repositionStock(vector<const Product*>& view, const Product* p, int oldStock);
 
 public:
-    ProductManager() {}
+    static constexpr uint32_t NO_ID = NameIndex::NO_ID;
+
+    ProductManager() { nameIndex.attach(products); }
+    ProductManager(const ProductManager&) = delete;    //the name index points into products
+    ProductManager& operator=(const ProductManager&) = delete;
 
-    void loadProducts(const string& filename);    //read products from file and load them into the map
-    void saveProductsToFile(const string& filename);
+    //read products.txt or a binary catalog (told apart by its magic) and assign ids in file order.
+    //false if the file is missing, empty or a corrupt binary catalog
+    bool loadProducts(const string& filename);
+    bool saveProductsToFile(const string& filename);    //text format
+    bool saveCatalogFile(const string& filename) const;    //binary columnar format, see catalog_file.h
+    string textCatalogBytes() const;    //what the saves write, for callers that need replaceFile(..., true)
+    string catalogFileBytes() const;
 
     Product* getProduct(const string& name);   
-    vector<Product> getAllProducts();    //getting all the products
-    vector<Product> getProductsByCategory(const string& category);    //getting products with same category
-    bool updateStock(const string& name, int quantity);    //update stock quantity after each checkout
+    Product* getProduct(uint32_t id) { return id < products.size() ? &products[id] : nullptr; }
+    const Product* getProduct(uint32_t id) const { return id < products.size() ? &products[id] : nullptr; }
+    uint32_t findId(string_view name) const { return nameIndex.find(name); }    //NO_ID if unknown
+    size_t size() const { return products.size(); }
+
+    vector<const Product*> getAllProductRefs() const;    //pointers in id order, valid until the next load
+    bool updateStock(uint32_t id, int quantity);    //update stock quantity after each checkout
+    bool updateStock(const string& name, int quantity);
 
     void displayProduct(const Product& p); 
 
-    vector<Product> applyFilters(const vector<Product>& input, const ProductFilters& f);    //apply filters
+    const string& categoryName(const Product& p) const { return categories.name(p.categoryId); }
+    const string& brandName(const Product& p) const { return brands.name(p.brandId); }
+    uint32_t categoryIdOf(const string& category) const { return categories.find(category); }    //NO_ID if unknown
+    uint32_t brandIdOf(const string& brand) const { return brands.find(brand); }
+    void setCategory(Product& p, const string& category) { p.categoryId = categories.intern(category); }
+    void setBrand(Product& p, const string& brand) { p.brandId = brands.intern(brand); }
+
+    vector<const Product*> filterCatalog(const ProductFilters& f) const;    //filter the whole catalog, via postings or columns
+
+    //ready-made order of the catalog or one category, no copies: O(1), page() and where() chain on it
+    ProductView view(SortType type = SORT_NONE, const string& category = "") const;
 
-    vector<Product> sortProducts(vector<Product> input, SortType type);    //display product list acc to sort type
+    void writeSnapshot(SnapshotWriter& w) const;    //binary dump for fast startup
+    bool readSnapshot(SnapshotReader& r);    //replace products with the snapshot contents
 };
 
 #endif
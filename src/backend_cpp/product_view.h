@@ -0,0 +1,120 @@
+#ifndef PRODUCT_VIEW_H
+#define PRODUCT_VIEW_H
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+using namespace std;
+
+struct Product;
+
+//walks an array of product pointers and hands out const Product&
+class ProductIterator {
+private:
+    const Product* const* pos = nullptr;
+
+public:
+    using iterator_category = random_access_iterator_tag;
+    using value_type = Product;
+    using difference_type = ptrdiff_t;
+    using pointer = const Product*;
+    using reference = const Product&;
+
+    ProductIterator() {}
+    explicit ProductIterator(const Product* const* p) : pos(p) {}
+
+    reference operator*() const { return **pos; }
+    pointer operator->() const { return *pos; }
+    reference operator[](difference_type n) const { return *pos[n]; }
+
+    ProductIterator& operator++() { ++pos; return *this; }
+    ProductIterator operator++(int) { ProductIterator old = *this; ++pos; return old; }
+    ProductIterator& operator--() { --pos; return *this; }
+    ProductIterator operator--(int) { ProductIterator old = *this; --pos; return old; }
+    ProductIterator& operator+=(difference_type n) { pos += n; return *this; }
+    ProductIterator& operator-=(difference_type n) { pos -= n; return *this; }
+    ProductIterator operator+(difference_type n) const { return ProductIterator(pos + n); }
+    ProductIterator operator-(difference_type n) const { return ProductIterator(pos - n); }
+    difference_type operator-(const ProductIterator& o) const { return pos - o.pos; }
+
+    bool operator==(const ProductIterator& o) const { return pos == o.pos; }
+    bool operator!=(const ProductIterator& o) const { return pos != o.pos; }
+    bool operator<(const ProductIterator& o) const { return pos < o.pos; }
+};
+
+//lazy filter over another range: products are tested while iterating, nothing is collected
+template <typename Range, typename Pred>
+class FilteredProducts {
+private:
+    Range range;
+    Pred pred;
+
+public:
+    using base_iterator = decltype(declval<const Range&>().begin());
+
+    class iterator {
+    private:
+        base_iterator cur, last;
+        const Pred* pred = nullptr;
+
+        void skip() { while (cur != last && !(*pred)(*cur)) ++cur; }
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Product;
+        using difference_type = ptrdiff_t;
+        using pointer = const Product*;
+        using reference = const Product&;
+
+        iterator() {}
+        iterator(base_iterator c, base_iterator l, const Pred* p) : cur(c), last(l), pred(p) { skip(); }
+
+        reference operator*() const { return *cur; }
+        pointer operator->() const { return &*cur; }
+        iterator& operator++() { ++cur; skip(); return *this; }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& o) const { return cur == o.cur; }
+        bool operator!=(const iterator& o) const { return cur != o.cur; }
+    };
+
+    FilteredProducts(Range r, Pred p) : range(r), pred(p) {}
+
+    iterator begin() const { return iterator(range.begin(), range.end(), &pred); }
+    iterator end() const { return iterator(range.end(), range.end(), &pred); }
+    bool empty() const { return begin() == end(); }
+
+    template <typename Pred2>
+    FilteredProducts<FilteredProducts, Pred2> where(Pred2 p) const { return FilteredProducts<FilteredProducts, Pred2>(*this, p); }
+};
+
+//non-owning window of products in some order, e.g. a sorted view or search results.
+//copying a view copies two words, the products stay where they are.
+//valid as long as the pointer array it was made from (views of ProductManager: until the next load or stock update)
+class ProductView {
+private:
+    const Product* const* items = nullptr;
+    size_t count = 0;
+
+public:
+    ProductView() {}
+    ProductView(const Product* const* first, size_t n) : items(first), count(n) {}
+    ProductView(const vector<const Product*>& v) : items(v.data()), count(v.size()) {}
+
+    ProductIterator begin() const { return ProductIterator(items); }
+    ProductIterator end() const { return ProductIterator(items + count); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Product& operator[](size_t i) const { return *items[i]; }
+
+    //sub-window [offset, offset + limit), clamped to the view, O(1)
+    ProductView page(size_t offset, size_t limit) const {
+        if (offset >= count) return ProductView(items + count, 0);
+        return ProductView(items + offset, min(limit, count - offset));
+    }
+
+    template <typename Pred>
+    FilteredProducts<ProductView, Pred> where(Pred p) const { return FilteredProducts<ProductView, Pred>(*this, p); }
+};
+
+#endif
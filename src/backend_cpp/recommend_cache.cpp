@@ -0,0 +1,54 @@
+#include "recommend_cache.h"
+#include <utility>
+
+const string* RecommendCache::lookup(uint32_t productId, size_t maxResults, uint64_t revision) {
+    if (maxResults <= RECOMMEND_CACHE_MAX_RESULTS) {
+        Table &t = tables[maxResults];
+        auto it = t.index.find(productId);
+        if (it != t.index.end()) {
+            Entry &e = t.slots[it->second];
+            if (e.revision == revision) {
+                e.referenced = true;
+                hits++;
+                return &e.response;
+            }
+        }
+    }
+    misses++;
+    return nullptr;
+}
+
+void RecommendCache::store(uint32_t productId, size_t maxResults, uint64_t revision, string response) {
+    if (capacity == 0 || maxResults > RECOMMEND_CACHE_MAX_RESULTS) return;
+    Table &t = tables[maxResults];
+
+    uint32_t slot;
+    auto it = t.index.find(productId);
+    if (it != t.index.end()) {    //stale entry of the same product, refresh in place
+        slot = it->second;
+    } else if (t.slots.size() < capacity) {
+        slot = static_cast<uint32_t>(t.slots.size());
+        t.slots.emplace_back();
+        t.index[productId] = slot;
+    } else {
+        while (t.slots[t.hand].referenced) {
+            t.slots[t.hand].referenced = false;
+            t.hand = (t.hand + 1) % t.slots.size();
+        }
+        slot = static_cast<uint32_t>(t.hand);
+        t.hand = (t.hand + 1) % t.slots.size();
+        t.index.erase(t.slots[slot].productId);
+        t.index[productId] = slot;
+    }
+
+    Entry &e = t.slots[slot];
+    e.productId = productId;
+    e.revision = revision;
+    e.referenced = false;
+    e.response = move(response);
+}
+
+void RecommendCache::clear() {
+    for (Table &t : tables) t = Table();
+    hits = misses = 0;
+}
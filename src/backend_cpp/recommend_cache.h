@@ -0,0 +1,49 @@
+#ifndef RECOMMEND_CACHE_H
+#define RECOMMEND_CACHE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+const size_t RECOMMEND_CACHE_SLOTS = 1024;    //responses kept per maxResults value
+const size_t RECOMMEND_CACHE_MAX_RESULTS = 16;    //larger maxResults values are not cached
+
+//rendered RECOMMEND responses, one CLOCK cache per maxResults value. a hit is one hash probe
+//plus a revision compare, so hot products never touch the graph or the catalog. the product's
+//graph revision is the only invalidation, so a checkout only turns the rows it changed into misses
+class RecommendCache {
+private:
+    struct Entry {
+        uint32_t productId;
+        uint64_t revision;    //productRevision() the response was computed at
+        bool referenced;    //second chance for the clock hand
+        string response;
+    };
+
+    //CLOCK: the hand skips (and clears) referenced entries and evicts the first unreferenced one
+    struct Table {
+        vector<Entry> slots;
+        unordered_map<uint32_t, uint32_t> index;    //product id -> slot
+        size_t hand = 0;
+    };
+
+    Table tables[RECOMMEND_CACHE_MAX_RESULTS + 1];    //indexed by maxResults
+    size_t capacity;
+    size_t hits = 0, misses = 0;
+
+public:
+    explicit RecommendCache(size_t slotsPerTable = RECOMMEND_CACHE_SLOTS) : capacity(slotsPerTable) {}
+
+    //cached response for the product, nullptr if missing or computed at another graph revision
+    const string* lookup(uint32_t productId, size_t maxResults, uint64_t revision);
+    void store(uint32_t productId, size_t maxResults, uint64_t revision, string response);
+    void clear();
+
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+};
+
+#endif
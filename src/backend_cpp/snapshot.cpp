@@ -0,0 +1,71 @@
+#include "snapshot.h"
+#include "product.h"
+#include "trie.h"
+#include "graph.h"
+#include "catalog_file.h"
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = {'E', 'C', 'S', 'N', 'A', 'P', '0', '1'};
+static const uint32_t SNAPSHOT_VERSION = 10;    //bump whenever a section layout changes
+static const uint32_t SNAPSHOT_END = 0x444E4523;    // "#END"
+
+static void writeSource(SnapshotWriter& w, const SnapshotSource& source) {
+    w.putU64(source.products.size);
+    w.putU64(static_cast<uint64_t>(source.products.mtime));
+    w.putU64(source.edges.size);
+    w.putU64(static_cast<uint64_t>(source.edges.mtime));
+}
+
+//magic, version, checksum of everything after it, then the sections. replaceFile() syncs
+//before the rename, so a crash leaves the old snapshot or the new one
+bool saveSnapshot(const string& filename, const SnapshotSource& source, const ProductManager& pm,
+                  const Trie& trie, const RecommendationGraph& graph) {
+    SnapshotWriter w;
+    w.putBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    w.putU32(SNAPSHOT_VERSION);
+    size_t checksumAt = w.data().size();
+    w.putU64(0);
+    writeSource(w, source);
+
+    pm.writeSnapshot(w);
+    trie.writeSnapshot(w);
+    graph.writeSnapshot(w);
+    w.putU32(SNAPSHOT_END);
+
+    size_t body = checksumAt + sizeof(uint64_t);
+    w.putU64At(checksumAt, catalogChecksum(w.data().data() + body, w.data().size() - body));
+    return replaceFile(filename, w.data(), true);
+}
+
+bool loadSnapshot(const string& filename, const SnapshotSource& source, ProductManager& pm,
+                  Trie& trie, RecommendationGraph& graph) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    SnapshotReader r(file.data(), file.size());
+    const char* magic = r.take(sizeof(SNAPSHOT_MAGIC));
+    if (!magic || memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) return false;
+    if (r.getU32() != SNAPSHOT_VERSION) return false;
+    uint64_t checksum = r.getU64();
+    const char* body = r.position();
+    size_t bodySize = r.remaining();
+
+    //stale if the catalog file or recommendations.txt changed since it was written
+    SnapshotSource stored;
+    stored.products.size = r.getU64();
+    stored.products.mtime = static_cast<int64_t>(r.getU64());
+    stored.edges.size = r.getU64();
+    stored.edges.mtime = static_cast<int64_t>(r.getU64());
+    if (!r.ok() || stored.products != source.products || stored.edges != source.edges)
+        return false;
+
+    //a torn or corrupt file must never reach the section readers
+    if (catalogChecksum(body, bodySize) != checksum) return false;
+
+    if (!pm.readSnapshot(r)) return false;
+    if (!trie.readSnapshot(r)) return false;
+    if (!graph.readSnapshot(r)) return false;
+
+    return r.getU32() == SNAPSHOT_END && r.ok();
+}
@@ -0,0 +1,103 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "mapped_file.h"
+#include <string>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+class ProductManager;
+class Trie;
+class RecommendationGraph;
+
+//appends little-endian binary fields to an in-memory buffer
+class SnapshotWriter {
+private:
+    string buffer;
+
+public:
+    void putBytes(const void* p, size_t n) { buffer.append(static_cast<const char*>(p), n); }
+    void putU8(uint8_t v) { putBytes(&v, sizeof(v)); }
+    void putU32(uint32_t v) { putBytes(&v, sizeof(v)); }
+    void putU64(uint64_t v) { putBytes(&v, sizeof(v)); }
+    void putI32(int32_t v) { putBytes(&v, sizeof(v)); }
+    void putDouble(double v) { putBytes(&v, sizeof(v)); }
+    void putU64At(size_t offset, uint64_t v) { memcpy(&buffer[offset], &v, sizeof(v)); }    //patch a placeholder
+    void putString(const string& s) {
+        putU32(static_cast<uint32_t>(s.size()));
+        putBytes(s.data(), s.size());
+    }
+
+    const string& data() const { return buffer; }
+};
+
+//bounds-checked reader over a mapped snapshot, every getter fails softly
+class SnapshotReader {
+private:
+    const char* cur;
+    const char* end;
+    bool good;
+
+public:
+    SnapshotReader(const char* data, size_t size) : cur(data), end(data + size), good(true) {}
+
+    //pointer to the next n bytes inside the mapping, nullptr if the file is too short
+    const char* take(size_t n) {
+        if (!good || static_cast<size_t>(end - cur) < n) {
+            good = false;
+            return nullptr;
+        }
+        const char* p = cur;
+        cur += n;
+        return p;
+    }
+
+    template <typename T>
+    T get() {
+        T v{};
+        const char* p = take(sizeof(T));
+        if (p) memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    const char* position() const { return cur; }
+    size_t remaining() const { return good ? static_cast<size_t>(end - cur) : 0; }
+
+    //element count of a section whose elements take at least minBytes each. a count the rest of
+    //the file cannot hold fails the reader and returns 0, so corrupt counts never size an allocation
+    uint32_t getCount(size_t minBytes) {
+        uint32_t n = getU32();
+        if (uint64_t(n) * minBytes > remaining()) {
+            good = false;
+            return 0;
+        }
+        return n;
+    }
+
+    uint8_t getU8() { return get<uint8_t>(); }
+    uint32_t getU32() { return get<uint32_t>(); }
+    uint64_t getU64() { return get<uint64_t>(); }
+    int32_t getI32() { return get<int32_t>(); }
+    double getDouble() { return get<double>(); }
+    string getString() {
+        uint32_t n = getU32();
+        const char* p = take(n);
+        return p ? string(p, n) : string();
+    }
+
+    bool ok() const { return good; }
+};
+
+//what the snapshot was built from, a mismatch means it is stale
+struct SnapshotSource {
+    FileStamp products;
+    FileStamp edges;    //recommendations.txt
+};
+
+bool saveSnapshot(const string& filename, const SnapshotSource& source, const ProductManager& pm,
+                  const Trie& trie, const RecommendationGraph& graph);
+bool loadSnapshot(const string& filename, const SnapshotSource& source, ProductManager& pm,
+                  Trie& trie, RecommendationGraph& graph);    //false if missing, stale or corrupt
+
+#endif
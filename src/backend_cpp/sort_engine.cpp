@@ -0,0 +1,88 @@
+#include "sort_engine.h"
+#include "text_normalize.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+vector<SortKey> sortKeysFor(SortType type) {
+    switch (type) {
+        case SORT_PRICE_ASC:
+            return {{FIELD_PRICE, false}};
+        case SORT_PRICE_DESC:
+            return {{FIELD_PRICE, true}};
+        case SORT_NAME_ASC:
+            return {{FIELD_NAME, false}};
+        case SORT_STOCK_DESC:
+            return {{FIELD_STOCK, true}};
+        default:
+            return {};
+    }
+}
+
+struct KeyedIndex {
+    uint64_t key;
+    uint32_t index;
+};
+
+//map a double to an unsigned key with the same order
+static inline uint64_t orderedBits(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+}
+
+//stable LSD radix sort by key, one pass per byte, bytes that are equal everywhere are skipped
+static void radixSort(vector<KeyedIndex>& v) {
+    if (v.size() < 64) {    //tiny inputs: the counting passes cost more than they save
+        stable_sort(v.begin(), v.end(), [](const KeyedIndex& a, const KeyedIndex& b) { return a.key < b.key; });
+        return;
+    }
+
+    vector<KeyedIndex> tmp(v.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[257] = {0};
+        for (const KeyedIndex& e : v) count[((e.key >> shift) & 0xFF) + 1]++;
+        if (count[((v[0].key >> shift) & 0xFF) + 1] == v.size()) continue;
+
+        for (int b = 0; b < 256; b++) count[b + 1] += count[b];
+        for (const KeyedIndex& e : v) tmp[count[(e.key >> shift) & 0xFF]++] = e;
+        v.swap(tmp);
+    }
+}
+
+vector<uint32_t> sortPermutation(const vector<const Product*>& items, const vector<SortKey>& keys) {
+    vector<uint32_t> perm(items.size());
+    for (uint32_t i = 0; i < perm.size(); i++) perm[i] = i;
+
+    vector<string> collation;    //folded names, built only when a name key is used
+    vector<KeyedIndex> keyed(items.size());
+
+    //least significant key first, every pass is stable so earlier keys break ties
+    for (size_t k = keys.size(); k-- > 0;) {
+        const SortKey& key = keys[k];
+
+        if (key.field == FIELD_NAME) {
+            if (collation.empty()) {
+                collation.reserve(items.size());
+                for (const Product* p : items) collation.push_back(foldKey(p->name));
+            }
+            auto less = [&](uint32_t a, uint32_t b) {
+                return key.descending ? collation[b] < collation[a] : collation[a] < collation[b];
+            };
+            stable_sort(perm.begin(), perm.end(), less);
+            continue;
+        }
+
+        for (size_t i = 0; i < perm.size(); i++) {
+            const Product* p = items[perm[i]];
+            uint64_t value = key.field == FIELD_PRICE
+                ? orderedBits(p->price)
+                : (uint64_t)((uint32_t)p->stock ^ 0x80000000u);
+            keyed[i] = {key.descending ? ~value : value, perm[i]};
+        }
+        radixSort(keyed);
+        for (size_t i = 0; i < perm.size(); i++) perm[i] = keyed[i].index;
+    }
+    return perm;
+}
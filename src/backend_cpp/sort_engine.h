@@ -0,0 +1,30 @@
+#ifndef SORT_ENGINE_H
+#define SORT_ENGINE_H
+
+#include "product.h"
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+enum SortField {
+    FIELD_PRICE,
+    FIELD_STOCK,
+    FIELD_NAME     // Case and accent insensitive (foldKey)
+};
+
+struct SortKey {
+    SortField field;
+    bool descending;
+};
+
+//sort keys behind each SortType, SORT_NONE has none
+vector<SortKey> sortKeysFor(SortType type);
+
+//stable multi-key sort, returns the permutation instead of moving products:
+//result[i] is the index into items of the i-th product in order.
+//keys are applied most significant first, equal products keep their input order.
+//numeric keys use an LSD radix sort on (key, index) pairs, names a stable sort on
+//collation keys computed once per call
+vector<uint32_t> sortPermutation(const vector<const Product*>& items, const vector<SortKey>& keys);
+
+#endif
@@ -0,0 +1,203 @@
+#include "stock_journal.h"
+#include "product.h"
+#include "catalog_parser.h"
+#include "catalog_file.h"
+#include "mapped_file.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+//checksum of the catalog file bytes, 0 when it cannot be read
+static uint64_t fileChecksum(const string& filename) {
+    MappedFile in;
+    if (!in.open(filename)) return 0;
+    return catalogChecksum(in.data(), in.size());
+}
+
+static string journalHeader(uint64_t checksum) {
+    return "#catalog " + to_string(checksum) + "\n";
+}
+
+//an empty journal for the catalog with this checksum
+bool StockJournal::restart(uint64_t checksum) {
+    if (file) fclose(file);
+    file = fopen(journalFile.c_str(), "wb");
+    unsynced = 0;
+    if (!file) {
+        bytes = 0;
+        cerr << "ERROR: Could not open " << journalFile << " for writing" << endl;
+        return false;
+    }
+    string header = journalHeader(checksum);
+    bool ok = fwrite(header.data(), 1, header.size(), file) == header.size();
+    syncToDisk(file);
+    bytes = header.size();
+    return ok;
+}
+
+vector<uint32_t> StockJournal::open(const string& journalFilename, const string& catalogFilename,
+                                    int syncEveryBatches) {
+    close();
+    journalFile = journalFilename;
+    catalogFile = catalogFilename;
+    syncEvery = max(1, syncEveryBatches);
+
+    string text;
+    {
+        ifstream in(journalFile, ios::binary);
+        if (in.is_open()) {
+            stringstream ss;
+            ss << in.rdbuf();
+            text = ss.str();
+        }
+    }
+
+    //the records hold absolute stock, so they only apply to the catalog they were written against.
+    //a catalog replaced since (edited, imported, restored) makes the whole journal stale
+    vector<uint32_t> changed;
+    uint64_t checksum = fileChecksum(catalogFile);
+    string header = journalHeader(checksum);
+    if (text.compare(0, header.size(), header) != 0) {
+        if (!text.empty()) cerr << "WARNING: " << journalFile << " does not match " << catalogFile << ", dropped" << endl;
+        restart(checksum);
+        return changed;
+    }
+
+    //apply whole batches only: a batch counts once its "=count" line is on disk
+    vector<pair<string_view, int>> pending;
+    size_t pos = header.size(), committed = pos;
+    while (pos < text.size()) {
+        size_t nl = text.find('\n', pos);
+        if (nl == string::npos) break;    //torn last line
+        string_view line(text.data() + pos, nl - pos);
+        pos = nl + 1;
+
+        size_t bar = line.rfind('|');
+        if (bar != string_view::npos) {
+            int stock = 0;
+            string_view num = line.substr(bar + 1);
+            if (from_chars(num.data(), num.data() + num.size(), stock).ec != errc()) break;
+            pending.push_back({line.substr(0, bar), stock});
+            continue;
+        }
+
+        size_t count = 0;
+        if (line.empty() || line[0] != '=' ||
+            from_chars(line.data() + 1, line.data() + line.size(), count).ec != errc() || count != pending.size())
+            break;    //garbage, nothing after it can be trusted
+
+        for (const auto &entry : pending) {
+            uint32_t id = catalog.findId(entry.first);
+            const Product* p = catalog.getProduct(id);
+            if (!p || p->stock == entry.second) continue;    //product gone from the catalog, or unchanged
+            catalog.updateStock(id, entry.second - p->stock);
+            changed.push_back(id);
+        }
+        pending.clear();
+        committed = pos;
+    }
+
+    //cut a torn tail so new batches do not get glued to half a line
+    error_code ec;
+    if (filesystem::exists(journalFile, ec) && committed < text.size())
+        filesystem::resize_file(journalFile, committed, ec);
+
+    file = fopen(journalFile.c_str(), "ab");
+    bytes = committed;
+    unsynced = 0;
+    if (!file) cerr << "ERROR: Could not open " << journalFile << " for writing" << endl;
+    return changed;
+}
+
+void StockJournal::close() {
+    if (!file) return;
+    syncToDisk(file);
+    fclose(file);
+    file = nullptr;
+}
+
+void StockJournal::sync() {
+    if (!file) return;
+    syncToDisk(file);
+    unsynced = 0;
+}
+
+bool StockJournal::append(const vector<uint32_t>& ids) {
+    if (!file) return false;
+
+    string batch;
+    size_t count = 0;
+    for (uint32_t id : ids) {
+        const Product* p = catalog.getProduct(id);
+        if (!p) continue;
+        batch += p->name;
+        batch += '|';
+        batch += to_string(p->stock);
+        batch += '\n';
+        count++;
+    }
+    batch += '=' + to_string(count) + '\n';
+
+    //one write per checkout, fflush hands it to the OS so a process crash cannot lose it
+    bool ok = fwrite(batch.data(), 1, batch.size(), file) == batch.size() && fflush(file) == 0;
+    bytes += batch.size();
+    if (++unsynced >= syncEvery) sync();
+
+    if (ok && bytes >= JOURNAL_COMPACT_BYTES) compact();
+    return ok;
+}
+
+//copy of products.txt with only the stock fields of changed products replaced,
+//so comments, blank lines and line order survive
+static void rewriteTextStock(const ProductManager& pm, const char* data, size_t size, string& out) {
+    out.reserve(size + size / 16);
+    const char* cur = data;
+    const char* last = data + size;
+    CatalogRow row;
+    while (cur < last) {
+        const char* nl = static_cast<const char*>(memchr(cur, '\n', last - cur));
+        const char* end = nl ? nl + 1 : last;
+        string_view line(cur, (nl ? nl : last) - cur);
+
+        const Product* p = nullptr;
+        if (parseCatalogLine(line, row)) p = pm.getProduct(pm.findId(row.name));
+        if (p && p->stock != row.stock) {
+            out.append(cur, row.stockText.data());
+            out += to_string(p->stock);
+            out.append(row.stockText.data() + row.stockText.size(), end);
+        } else {
+            out.append(cur, end);
+        }
+        cur = end;
+    }
+}
+
+bool StockJournal::compact() {
+    if (catalogFile.empty()) return false;
+    sync();
+
+    //every branch syncs the new catalog before the rename, so the journal is only dropped
+    //once the stock is on disk
+    string out;
+    MappedFile in;
+    if (in.open(catalogFile) && isCatalogFile(in.data(), in.size())) {
+        out = catalog.catalogFileBytes();
+    } else if (in.data()) {
+        rewriteTextStock(catalog, in.data(), in.size(), out);
+    } else {
+        out = catalog.textCatalogBytes();    //no catalog file to keep the layout of
+    }
+    in.close();    //windows cannot replace a mapped file
+
+    if (!replaceFile(catalogFile, out, true)) return false;    //keep the journal, it still holds the stock
+
+    //every batch is in the catalog now, start an empty journal for the new catalog. a crash before
+    //this leaves the old header, so the next start drops the journal instead of replaying it
+    return restart(catalogChecksum(out.data(), out.size()));
+}
@@ -0,0 +1,55 @@
+#ifndef STOCK_JOURNAL_H
+#define STOCK_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+using namespace std;
+
+class ProductManager;
+
+//sync the journal after this many checkouts (and on sync()/close()).
+//a crash of the process loses nothing, a power cut at most the unsynced checkouts
+const int JOURNAL_SYNC_EVERY = 8;
+
+//fold the journal into the catalog file once it grows past this
+const size_t JOURNAL_COMPACT_BYTES = 1 << 20;
+
+//append-only log of stock changes, so a checkout writes O(items) bytes instead of the catalog.
+//the first line "#catalog <checksum>" names the catalog file the journal applies to.
+//each checkout is one batch of "name|new stock" lines closed by "=count"; records hold the
+//absolute stock, so a batch is only replayed onto the catalog it was written against
+class StockJournal {
+private:
+    ProductManager& catalog;
+    string journalFile;
+    string catalogFile;    //where compaction writes the stock back
+    FILE* file = nullptr;
+    size_t bytes = 0;    //current journal size
+    int unsynced = 0;    //batches written since the last sync
+    int syncEvery = JOURNAL_SYNC_EVERY;
+
+    bool restart(uint64_t checksum);    //truncate to just the header
+
+public:
+    explicit StockJournal(ProductManager& pm) : catalog(pm) {}
+    ~StockJournal() { close(); }
+    StockJournal(const StockJournal&) = delete;
+    StockJournal& operator=(const StockJournal&) = delete;
+
+    //replay the complete batches of an existing journal into the catalog, drop a torn tail and
+    //open it for appending. a journal written against another catalog file is dropped unread.
+    //returns the ids whose stock changed
+    vector<uint32_t> open(const string& journalFilename, const string& catalogFilename,
+                          int syncEveryBatches = JOURNAL_SYNC_EVERY);
+    void close();    //sync and close
+
+    bool append(const vector<uint32_t>& ids);    //log the current stock of these products as one batch
+    void sync();    //flush and fsync now
+    bool compact();    //write the current stock into the catalog file and empty the journal
+
+    size_t size() const { return bytes; }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "text_normalize.h"
+#include <cstdint>
+
+using namespace std;
+
+//ASCII replacement for U+00C0..U+017F (Latin-1 Supplement letters + Latin Extended-A),
+//nullptr where the character has no letter form (×, ÷)
+static const char* const LATIN_FOLD[] = {
+    // U+00C0
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    // U+00D0
+    "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", "th", "ss",
+    // U+00E0
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    // U+00F0
+    "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", "th", "y",
+    // U+0100
+    "a", "a", "a", "a", "a", "a", "c", "c", "c", "c", "c", "c", "c", "c", "d", "d",
+    // U+0110
+    "d", "d", "e", "e", "e", "e", "e", "e", "e", "e", "e", "e", "g", "g", "g", "g",
+    // U+0120
+    "g", "g", "g", "g", "h", "h", "h", "h", "i", "i", "i", "i", "i", "i", "i", "i",
+    // U+0130
+    "i", "i", "ij", "ij", "j", "j", "k", "k", "k", "l", "l", "l", "l", "l", "l", "l",
+    // U+0140
+    "l", "l", "l", "n", "n", "n", "n", "n", "n", "n", "n", "n", "o", "o", "o", "o",
+    // U+0150
+    "o", "o", "oe", "oe", "r", "r", "r", "r", "r", "r", "s", "s", "s", "s", "s", "s",
+    // U+0160
+    "s", "s", "t", "t", "t", "t", "t", "t", "u", "u", "u", "u", "u", "u", "u", "u",
+    // U+0170
+    "u", "u", "u", "u", "w", "w", "y", "y", "y", "z", "z", "z", "z", "z", "z", "s",
+};
+
+//decode one UTF-8 sequence starting at i, invalid bytes come back as themselves
+static uint32_t decodeUtf8(string_view s, size_t &i, size_t &len) {
+    uint8_t c = s[i];
+    uint32_t cp = c;
+    len = 1;
+    if (c >= 0xC0 && c < 0xE0) { cp = c & 0x1F; len = 2; }
+    else if (c >= 0xE0 && c < 0xF0) { cp = c & 0x0F; len = 3; }
+    else if (c >= 0xF0 && c < 0xF8) { cp = c & 0x07; len = 4; }
+    else return cp;    //ASCII or stray continuation byte
+
+    if (i + len > s.size()) {
+        len = 1;
+        return c;
+    }
+    for (size_t k = 1; k < len; k++) {
+        uint8_t cc = s[i + k];
+        if ((cc & 0xC0) != 0x80) {
+            len = 1;
+            return c;
+        }
+        cp = (cp << 6) | (cc & 0x3F);
+    }
+    return cp;
+}
+
+static void appendUtf8(string &out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += char(cp);
+    } else if (cp < 0x800) {
+        out += char(0xC0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += char(0xE0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    } else {
+        out += char(0xF0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3F));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    }
+}
+
+string foldKey(string_view text) {
+    string out;
+    out.reserve(text.size());
+
+    size_t i = 0;
+    while (i < text.size()) {
+        uint8_t c = text[i];
+        if (c < 0x80) {    //fast path for ASCII
+            out += (c >= 'A' && c <= 'Z') ? char(c + 32) : char(c);
+            i++;
+            continue;
+        }
+
+        size_t len;
+        uint32_t cp = decodeUtf8(text, i, len);
+
+        if (len == 1) {
+            out += char(c);    //not valid UTF-8, keep the raw byte
+        } else if (cp >= 0x0300 && cp <= 0x036F) {
+            //combining accent (decomposed input), dropped
+        } else if (cp >= 0x00C0 && cp <= 0x017F && LATIN_FOLD[cp - 0x00C0]) {
+            out += LATIN_FOLD[cp - 0x00C0];
+        } else if (cp == 0x2018 || cp == 0x2019 || cp == 0x02BC) {
+            out += '\'';    //curly apostrophes
+        } else if (cp == 0x201C || cp == 0x201D) {
+            out += '"';
+        } else if (cp >= 0x2010 && cp <= 0x2015) {
+            out += '-';    //hyphens and dashes
+        } else if (cp == 0x00A0) {
+            out += ' ';    //no-break space
+        } else if (cp >= 0x0391 && cp <= 0x03A9 && cp != 0x03A2) {
+            appendUtf8(out, cp + 32);    //Greek capitals
+        } else if (cp >= 0x0410 && cp <= 0x042F) {
+            appendUtf8(out, cp + 32);    //Cyrillic capitals
+        } else if (cp >= 0x0400 && cp <= 0x040F) {
+            appendUtf8(out, cp + 80);
+        } else {
+            out.append(text.substr(i, len));
+        }
+        i += len;
+    }
+    return out;
+}
@@ -0,0 +1,14 @@
+#ifndef TEXT_NORMALIZE_H
+#define TEXT_NORMALIZE_H
+
+#include <string>
+#include <string_view>
+using namespace std;
+
+//search key for a UTF-8 string: case folded and accent insensitive.
+//"Ikigai by Héctor García" -> "ikigai by hector garcia", "Man’s" -> "man's".
+//digits, spaces and punctuation are kept so "iPhone 15" and "iPhone" stay different keys,
+//characters without a folding rule pass through as their original UTF-8 bytes
+string foldKey(string_view text);
+
+#endif
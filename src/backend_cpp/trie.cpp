@@ -1,96 +1,273 @@
 #include "trie.h"
+#include "snapshot.h"
+#include "product.h"
+#include "text_normalize.h"
 #include <algorithm>
 
 //initialize trie with root node
 Trie::Trie() {
-    root = new TrieNode();
+    nodes.push_back(TrieNode());
 }
-//free all trie nodes
-Trie::~Trie() {
-    deleteNode(root);
+
+void Trie::clear() {
+    nodes.assign(1, TrieNode());
+    for (auto& list : scores) list.clear();
+    cacheSlot.clear();
+    rankCache.clear();
+    cachesValid = false;
 }
 
-//delete all child nodes
-void Trie::deleteNode(TrieNode* node) {
-    if (!node) return;
-    for (int i = 0; i < 26; i++) {
-        if (node->children[i]) {
-            deleteNode(node->children[i]);
-        }
+uint32_t Trie::findChild(uint32_t node, uint32_t label) const {
+    for (uint32_t c = nodes[node].firstChild; c != TRIE_NONE; c = nodes[c].nextSibling) {
+        if (nodes[c].label == label) return c;
+        if (nodes[c].label > label) break;    //sibling list is sorted
     }
-    delete node;
+    return TRIE_NONE;
 }
 
-//insert word into trie
-void Trie::insert(const string& word) {
-    TrieNode* current = root;
-    string wordLower = word;     //lowercase for easy indexing
-    transform(wordLower.begin(), wordLower.end(), wordLower.begin(), ::tolower);
+uint32_t Trie::getOrAddChild(uint32_t node, uint32_t label) {
+    //find the insert position that keeps the sibling list sorted
+    uint32_t prev = TRIE_NONE;
+    uint32_t c = nodes[node].firstChild;
+    while (c != TRIE_NONE && nodes[c].label < label) {
+        prev = c;
+        c = nodes[c].nextSibling;
+    }
+    if (c != TRIE_NONE && nodes[c].label == label) return c;
 
-    //walk through each character
-    for (char c : wordLower) {
-        if (c < 'a' || c > 'z') continue; // Skip non-alphabetic
-        int index = c - 'a';
-        if (!current->children[index]) { 
-            current->children[index] = new TrieNode();
-        }
-        current = current->children[index];
+    uint32_t id = nodes.size();
+    nodes.push_back(TrieNode(label));    //may reallocate, so index again below
+    nodes[id].nextSibling = c;
+    if (prev == TRIE_NONE) nodes[node].firstChild = id;
+    else nodes[prev].nextSibling = id;
+    return id;
+}
+
+uint32_t Trie::findNode(const string& key) const {
+    uint32_t current = 0;
+    for (char ch : foldKey(key)) {
+        current = findChild(current, (uint8_t)ch);
+        if (current == TRIE_NONE) return TRIE_NONE;
     }
-    
-    current->isEndOfWord = true;
-    current->fullWord = word;
+    return current;
 }
 
-//check if a word exist in the trie
-bool Trie::search(const string& word) {
-    TrieNode* current = root;
-    string wordLower = word;
-    transform(wordLower.begin(), wordLower.end(), wordLower.begin(), ::tolower);
-    
-    for (char c : wordLower) {
-        if (c < 'a' || c > 'z') continue;
-        int index = c - 'a';
-        if (!current->children[index]) {    //checking word existance 
-            return false;
-        }
-        current = current->children[index];
+//insert a product's name into trie
+void Trie::insert(uint32_t productId) {
+    uint32_t current = 0;
+
+    //walk through each byte of the folded key, folding happens once here
+    for (char ch : foldKey(word(productId))) {
+        current = getOrAddChild(current, (uint8_t)ch);
     }
+
+    //same key inserted again: the newest product replaces the old one
+    if (productId >= scores[0].size())
+        for (auto& list : scores) list.resize(productId + 1, 0.0);
+    nodes[current].wordId = productId;
+    cachesValid = false;    //cached top lists are rebuilt on the next query
+}
+
+const string& Trie::word(uint32_t id) const {
+    return catalog->getProduct(id)->name;
+}
+
+uint32_t Trie::findWord(const string& word) const {
+    uint32_t node = findNode(word);
+    return node == TRIE_NONE ? TRIE_NONE : nodes[node].wordId;
+}
+
+//check if a word exist in the trie
+bool Trie::search(const string& word) const {
+    uint32_t node = findNode(word);
     //true only if we have a complete stored word
-    return current != nullptr && current->isEndOfWord;
+    return node != TRIE_NONE && nodes[node].wordId != TRIE_NONE;
 }
 
 // Return all words that start with the given prefix
-vector<string> Trie::autocomplete(const string& prefix) {
+vector<string> Trie::autocomplete(const string& prefix) const {
     vector<string> results;
-    TrieNode* current = root;
-    string prefixLower = prefix;
-    transform(prefixLower.begin(), prefixLower.end(), prefixLower.begin(), ::tolower);
-    
-    // Navigate to prefix node
-    for (char c : prefixLower) {
-        if (c < 'a' || c > 'z') continue;
-        int index = c - 'a';
-        if (!current->children[index]) {
-            return results; // No matches
-        }
-        current = current->children[index];
-    }
-    
+    for (uint32_t id : autocompleteIds(prefix)) results.push_back(word(id));
+    return results;
+}
+
+vector<uint32_t> Trie::autocompleteIds(const string& prefix) const {
+    vector<uint32_t> results;
+    uint32_t node = findNode(prefix);
+    if (node == TRIE_NONE) return results;    // No matches
+
     // Collect all words from this node
-    collectWords(current, results);
+    collectIds(node, results);
     return results;
 }
 
-void Trie::collectWords(TrieNode* node, vector<string>& results) {    //collecting all valid words reachable from a node
-    if (!node) return;
-    
-    if (node->isEndOfWord) {
-        results.push_back(node->fullWord);
+//collecting valid words reachable from a node in alphabetical order, stops after limit words
+void Trie::collectIds(uint32_t node, vector<uint32_t>& results, size_t limit) const {
+    //explicit stack instead of recursion, deep names cannot overflow the call stack
+    size_t found = 0;
+    vector<uint32_t> stack = {node};
+    while (!stack.empty() && found < limit) {
+        uint32_t cur = stack.back();
+        stack.pop_back();
+        if (nodes[cur].wordId != TRIE_NONE) {
+            results.push_back(nodes[cur].wordId);
+            found++;
+        }
+
+        //push children in reverse so the smallest label is visited first
+        size_t mark = stack.size();
+        for (uint32_t c = nodes[cur].firstChild; c != TRIE_NONE; c = nodes[c].nextSibling)
+            stack.push_back(c);
+        reverse(stack.begin() + mark, stack.end());
     }
-    
-    for (int i = 0; i < 26; i++) {    //explore all childs
-        if (node->children[i]) {
-            collectWords(node->children[i], results);
+}
+
+//higher score first, ties in alphabetical order
+bool Trie::ranksBefore(uint32_t a, uint32_t b, RankKey key) const {
+    if (scores[key][a] != scores[key][b]) return scores[key][a] > scores[key][b];
+    return word(a) < word(b);
+}
+
+//every word that can be in the node's top list: its own word plus each child's top list
+void Trie::gatherCandidates(uint32_t node, RankKey key, vector<uint32_t>& out) const {
+    if (nodes[node].wordId != TRIE_NONE) out.push_back(nodes[node].wordId);
+
+    for (uint32_t c = nodes[node].firstChild; c != TRIE_NONE; c = nodes[c].nextSibling) {
+        auto slot = cacheSlot.find(c);
+        if (slot == cacheSlot.end()) {
+            collectIds(c, out);    //small subtree, at most kCachedCompletions words
+            continue;
         }
+        const uint32_t* cached = &rankCache[(slot->second * (RANK_KEY_COUNT - 1) + key - 1) * kCachedCompletions];
+        for (size_t i = 0; i < kCachedCompletions && cached[i] != TRIE_NONE; i++) out.push_back(cached[i]);
     }
 }
+
+void Trie::fillCache(uint32_t node, uint32_t slot) const {
+    vector<uint32_t> candidates;
+    for (int key = RANK_NAME + 1; key < RANK_KEY_COUNT; key++) {
+        candidates.clear();
+        gatherCandidates(node, RankKey(key), candidates);
+
+        size_t keep = min(candidates.size(), kCachedCompletions);
+        partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+                     [&](uint32_t a, uint32_t b) { return ranksBefore(a, b, RankKey(key)); });
+
+        uint32_t* cached = &rankCache[(slot * (RANK_KEY_COUNT - 1) + key - 1) * kCachedCompletions];
+        for (size_t i = 0; i < kCachedCompletions; i++) cached[i] = i < keep ? candidates[i] : TRIE_NONE;
+    }
+}
+
+void Trie::rebuildRankCaches() const {
+    //a child is always created after its parent, so walking indexes backwards is a post-order
+    vector<uint32_t> subtreeWords(nodes.size(), 0);
+    for (size_t i = nodes.size(); i-- > 0;) {
+        uint32_t count = nodes[i].wordId != TRIE_NONE ? 1 : 0;
+        for (uint32_t c = nodes[i].firstChild; c != TRIE_NONE; c = nodes[c].nextSibling) count += subtreeWords[c];
+        subtreeWords[i] = count;
+    }
+
+    cacheSlot.clear();
+    for (size_t i = nodes.size(); i-- > 0;) {
+        if (subtreeWords[i] > kCachedCompletions) cacheSlot.emplace(i, cacheSlot.size());
+    }
+    rankCache.assign(cacheSlot.size() * (RANK_KEY_COUNT - 1) * kCachedCompletions, TRIE_NONE);
+
+    for (size_t i = nodes.size(); i-- > 0;) {
+        auto slot = cacheSlot.find(i);
+        if (slot != cacheSlot.end()) fillCache(i, slot->second);
+    }
+    cachesValid = true;
+}
+
+void Trie::setScore(uint32_t wordId, RankKey key, double score) {
+    if (key == RANK_NAME || wordId >= scores[key].size() || scores[key][wordId] == score) return;
+    scores[key][wordId] = score;
+    if (!cachesValid) return;
+
+    //only the caches on the path down to this word can change, refresh them deepest first
+    vector<uint32_t> path = {0};
+    for (char ch : foldKey(word(wordId))) {
+        uint32_t next = findChild(path.back(), (uint8_t)ch);
+        if (next == TRIE_NONE) return;    //not indexed
+        path.push_back(next);
+    }
+    for (size_t i = path.size(); i-- > 0;) {
+        auto slot = cacheSlot.find(path[i]);
+        if (slot != cacheSlot.end()) fillCache(path[i], slot->second);
+    }
+}
+
+vector<uint32_t> Trie::topCompletions(const string& prefix, size_t k, RankKey key) const {
+    vector<uint32_t> results;
+    uint32_t node = findNode(prefix);
+    if (node == TRIE_NONE || k == 0) return results;
+
+    //alphabetical order is the walk order, so stop after k words
+    if (key == RANK_NAME) {
+        collectIds(node, results, k);
+        return results;
+    }
+
+    if (!cachesValid) rebuildRankCaches();
+
+    auto slot = cacheSlot.find(node);
+    if (slot != cacheSlot.end() && k <= kCachedCompletions) {
+        const uint32_t* cached = &rankCache[(slot->second * (RANK_KEY_COUNT - 1) + key - 1) * kCachedCompletions];
+        for (size_t i = 0; i < k && cached[i] != TRIE_NONE; i++) results.push_back(cached[i]);
+        return results;
+    }
+
+    //small subtree (or k above the cache size): rank the whole subtree
+    collectIds(node, results);
+    size_t keep = min(results.size(), k);
+    partial_sort(results.begin(), results.begin() + keep, results.end(),
+                 [&](uint32_t a, uint32_t b) { return ranksBefore(a, b, key); });
+    results.resize(keep);
+    return results;
+}
+
+//the node array has no pointers, so it is written and read back as one block
+void Trie::writeSnapshot(SnapshotWriter& w) const {
+    w.putU32(static_cast<uint32_t>(nodes.size()));
+    w.putBytes(nodes.data(), nodes.size() * sizeof(TrieNode));
+    w.putU32(static_cast<uint32_t>(scores[0].size()));
+    for (int key = RANK_NAME + 1; key < RANK_KEY_COUNT; key++)
+        w.putBytes(scores[key].data(), scores[key].size() * sizeof(double));
+}
+
+bool Trie::readSnapshot(SnapshotReader& r) {
+    uint32_t nodeCount = r.getU32();
+    const char* raw = r.take(size_t(nodeCount) * sizeof(TrieNode));
+    if (!raw || nodeCount == 0) return false;
+
+    vector<TrieNode> loadedNodes(nodeCount);
+    memcpy(loadedNodes.data(), raw, size_t(nodeCount) * sizeof(TrieNode));
+
+    //one score per ranked key, names come from the catalog loaded before the trie
+    uint32_t wordCount = r.getCount((RANK_KEY_COUNT - 1) * sizeof(double));
+    if (!catalog || wordCount > catalog->size()) return false;
+
+    vector<double> loadedScores[RANK_KEY_COUNT];
+    loadedScores[RANK_NAME].assign(wordCount, 0.0);
+    for (int key = RANK_NAME + 1; key < RANK_KEY_COUNT; key++) {
+        const char* rawScores = r.take(size_t(wordCount) * sizeof(double));
+        if (!rawScores) return false;
+        loadedScores[key].resize(wordCount);
+        memcpy(loadedScores[key].data(), rawScores, size_t(wordCount) * sizeof(double));
+    }
+    if (!r.ok()) return false;
+
+    //reject links that point outside the arrays
+    for (const TrieNode& n : loadedNodes) {
+        if ((n.firstChild != TRIE_NONE && n.firstChild >= nodeCount) ||
+            (n.nextSibling != TRIE_NONE && n.nextSibling >= nodeCount) ||
+            (n.wordId != TRIE_NONE && n.wordId >= wordCount))
+            return false;
+    }
+
+    nodes.swap(loadedNodes);
+    for (int key = 0; key < RANK_KEY_COUNT; key++) scores[key].swap(loadedScores[key]);
+    cachesValid = false;    //top lists are rebuilt on the first ranked query
+    return true;
+}
@@ -3,36 +3,79 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <cstdint>
 using namespace std;
 
-class TrieNode {
-public:
-    TrieNode* children[26];    //pointers for each alphabet
-    bool isEndOfWord;
-    string fullWord;    //actual word
-    
-    TrieNode() {
-        for (int i = 0; i < 26; i++) {
-            children[i] = nullptr;    // initialize all children as empty
-        }
-        isEndOfWord = false;
-        fullWord = "";
-    }
+class SnapshotWriter;
+class SnapshotReader;
+class ProductManager;
+
+const uint32_t TRIE_NONE = UINT32_MAX;    //no node / no product
+
+//16 byte node stored in one arena, links are 32-bit indexes instead of pointers
+struct TrieNode {
+    uint32_t firstChild;    //children form a list sorted by label
+    uint32_t nextSibling;
+    uint32_t wordId;    //product id of the name ending here, TRIE_NONE if none
+    uint32_t label;    //byte of the folded key on the edge into this node
+
+    TrieNode(uint32_t l = 0) : firstChild(TRIE_NONE), nextSibling(TRIE_NONE), wordId(TRIE_NONE), label(l) {}
+};
+
+//ranking used for top-K autocomplete
+enum RankKey {
+    RANK_NAME,         // Alphabetical
+    RANK_STOCK,        // Most stock first
+    RANK_PRICE_LOW,    // Cheapest first
+    RANK_KEY_COUNT
 };
 
-//trie for auto complete and fast prefix searches
+const size_t kCachedCompletions = 16;    //best completions kept per large subtree and rank key
+
+//trie for auto complete and fast prefix searches over case/accent folded keys
+//(see foldKey), children are sibling lists so node size does not grow with the alphabet.
+//terminal nodes hold product ids, the names themselves stay in the product manager
 class Trie {
 private:
-    TrieNode* root;    //root node of the trie
-    void collectWords(TrieNode* node, vector<string>& results);
-    void deleteNode(TrieNode* node);    //free nodes recursively
+    vector<TrieNode> nodes;    //nodes[0] is the root
+    const ProductManager* catalog = nullptr;    //resolves ids to names
+    vector<double> scores[RANK_KEY_COUNT];    //product id -> score per rank key, higher ranks first
+
+    //only nodes with more than kCachedCompletions words get a cache slot, smaller
+    //subtrees are cheaper to walk than to cache
+    mutable unordered_map<uint32_t, uint32_t> cacheSlot;    //node -> slot
+    mutable vector<uint32_t> rankCache;    //slot -> kCachedCompletions ids per scored rank key
+    mutable bool cachesValid = false;
+
+    uint32_t findChild(uint32_t node, uint32_t label) const;
+    uint32_t getOrAddChild(uint32_t node, uint32_t label);
+    uint32_t findNode(const string& key) const;    //node reached by the key, TRIE_NONE if absent
+    void collectIds(uint32_t node, vector<uint32_t>& results, size_t limit = SIZE_MAX) const;
+    bool ranksBefore(uint32_t a, uint32_t b, RankKey key) const;
+    void gatherCandidates(uint32_t node, RankKey key, vector<uint32_t>& out) const;
+    void fillCache(uint32_t node, uint32_t slot) const;
+    void rebuildRankCaches() const;
     
 public:
     Trie();    //create empty trie
-    ~Trie();    //free memory
-    void insert(const string& word);    //insert a word into trie
-    bool search(const string& word);    //check if a word exists
-    vector<string> autocomplete(const string& prefix);    //all words starting with prefix
+    void attach(const ProductManager& pm) { catalog = &pm; }    //before inserting or loading a snapshot
+
+    void insert(uint32_t productId);    //index the product's name, a product with the same key is replaced
+    bool search(const string& word) const;    //check if a word exists
+    vector<string> autocomplete(const string& prefix) const;    //all names starting with prefix
+    vector<uint32_t> autocompleteIds(const string& prefix) const;    //same, as product ids
+    const string& word(uint32_t id) const;    //name of an indexed product
+    uint32_t findWord(const string& word) const;    //product id, TRIE_NONE if absent
+
+    void setScore(uint32_t wordId, RankKey key, double score);    //keeps the cached top lists current
+    vector<uint32_t> topCompletions(const string& prefix, size_t k, RankKey key) const;    //O(prefix + k) for cached prefixes
+    void clear();    //remove every word
+
+    size_t nodeCount() const { return nodes.size(); }
+
+    void writeSnapshot(SnapshotWriter& w) const;    //raw node array + score columns
+    bool readSnapshot(SnapshotReader& r);
 };
 
 #endif
@@ -6,6 +6,8 @@ from backend_interface import BackendInterface
 
 BASE_DIR = os.path.dirname(os.path.abspath(__file__))
 BACKEND_DIR = os.path.join(BASE_DIR, "..", "backend_cpp")
+# Rows fetched per LISTALL page when filling the product table
+ALL_PRODUCTS_PAGE_SIZE = 50
 
 # Using ttkbootstrap for modern themes
 USE_BOOTSTRAP = False
@@ -251,7 +253,8 @@ class ECommerceApp:
             self.hide_suggestions()
             return
 
-        result = self.backend.execute_command(f"AUTOCOMP {query}")
+        # Only the best few suggestions fit in the dropdown
+        result = self.backend.execute_command(f"AUTOCOMP {query} |limit=8")
         suggestions = result.get("suggestions", [])
 
         if not suggestions:
@@ -504,10 +507,31 @@ class ECommerceApp:
                                       bootstyle="success" if USE_BOOTSTRAP else None)
         add_btn.pack(side=tk.LEFT, padx=5)
 
-        result = self.backend.execute_command("LISTALL")
-        self.display_all_products(result.get("products", []))
+        #first page shows right away, the rest are appended in the background
+        self.products_pages = self.backend.iter_pages("LISTALL", ALL_PRODUCTS_PAGE_SIZE)
+        self.display_all_products([])
+        self.load_next_products_page(self.products_tree, 1)
         #showcase all products on panel
 
+    def load_next_products_page(self, tree, next_idx):
+        #stop if the user moved to another view meanwhile
+        if getattr(self, "products_tree", None) is not tree or not tree.winfo_exists():
+            return
+        result = next(self.products_pages, None)
+        if result is None:
+            return
+        if "error" in result:
+            messagebox.showerror("Error", result["error"])
+            return
+
+        products = result.get("products", [])
+        for idx, p in enumerate(products, next_idx):
+            tree.insert("", tk.END, text=str(idx),
+                        values=(p["name"], f"₹{p['price']:.2f}", p["stock"], p.get("category", "")))
+
+        if result.get("page", {}).get("cursor"):
+            self.root.after(1, self.load_next_products_page, tree, next_idx + len(products))
+
     #table population
     def display_all_products(self, products):
         if not hasattr(self, "products_tree"):
@@ -613,6 +637,7 @@ class CartWindow:
         self.update_callback = update_callback
         self.items = cart_data.get("items", [])
         self.total = cart_data.get("total", 0.0)
+        self.suggestions = cart_data.get("suggestions", [])
         self.setup_ui()
 
     def setup_ui(self):
@@ -654,6 +679,12 @@ class CartWindow:
         
         ttk.Label(footer, text=f"Total: ₹{self.total:.2f}", font=("Arial", 14, "bold")).pack(pady=10)
 
+        #products often bought with what is in the cart
+        if self.suggestions:
+            names = ", ".join(f"{s['name']} (₹{s['price']:.0f})" for s in self.suggestions)
+            ttk.Label(self.window, text=f"Complete your cart: {names}", wraplength=560,
+                      font=("Arial", 10)).pack(padx=10)
+
         #buttons
         button_frame = tk.Frame(self.window)
         button_frame.pack(fill=tk.X, padx=10, pady=10)
@@ -727,7 +758,9 @@ class RecommendationWindow:
 
 def main():
     root = tk.Tk()
-    ECommerceApp(root)
+    app = ECommerceApp(root)
+    # Stop the resident backend (it saves the cart) when the window closes
+    root.protocol("WM_DELETE_WINDOW", lambda: [app.backend.close(), root.destroy()])
     root.mainloop()
 
 if __name__ == "__main__":
@@ -1,15 +1,106 @@
 import subprocess
 import os
 import time
+import threading
+import queue
+
+# Line the backend prints after every response in --server mode
+RESPONSE_FRAME_END = "#END"
+
 
 class BackendInterface:
-    def __init__(self, cpp_executable, input_file, output_file):
+    def __init__(self, cpp_executable, input_file, output_file, persistent=True, timeout=5):
         # Store paths for backend executable and I/O files
         self.cpp_executable = cpp_executable
         self.input_file = input_file
         self.output_file = output_file
+        # Keep one resident backend process instead of spawning one per command
+        self.persistent = persistent
+        self.timeout = timeout
+        self._proc = None
+        self._lines = None
+        self._lock = threading.Lock()
 
     def execute_command(self, command):
+        if self.persistent:
+            try:
+                output = self._execute_on_server(command)
+                return self.parse_output(output, command)
+            except subprocess.TimeoutExpired:
+                self.close()
+                return {"error": "Backend timeout"}
+            except FileNotFoundError:
+                return {"error": f"C++ executable not found: {self.cpp_executable}"}
+            except Exception:
+                # Server could not be used, fall back to one-shot file mode
+                self.close()
+                self.persistent = False
+
+        return self._execute_once(command)
+
+    def _start_server(self):
+        self._proc = subprocess.Popen([self.cpp_executable, "--server"],
+                                      stdin=subprocess.PIPE,
+                                      stdout=subprocess.PIPE,
+                                      stderr=subprocess.DEVNULL,
+                                      text=True,
+                                      encoding='utf-8',
+                                      bufsize=1)
+        # Reader thread lets us wait on responses with a timeout
+        self._lines = queue.Queue()
+        proc = self._proc
+        lines = self._lines
+
+        def reader():
+            for line in proc.stdout:
+                lines.put(line.rstrip('\r\n'))
+            lines.put(None)    # backend exited
+
+        threading.Thread(target=reader, daemon=True).start()
+
+    def _execute_on_server(self, command):
+        with self._lock:
+            if self._proc is None or self._proc.poll() is not None:
+                self._start_server()
+
+            # One command per line, so newlines inside the command are flattened
+            line = ' '.join(command.strip().splitlines())
+            self._proc.stdin.write(line + '\n')
+            self._proc.stdin.flush()
+
+            # Collect lines until the frame terminator
+            output = []
+            deadline = time.monotonic() + self.timeout
+            while True:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    raise subprocess.TimeoutExpired(self.cpp_executable, self.timeout)
+                try:
+                    out_line = self._lines.get(timeout=remaining)
+                except queue.Empty:
+                    raise subprocess.TimeoutExpired(self.cpp_executable, self.timeout)
+                if out_line is None:
+                    raise RuntimeError("Backend server exited")
+                if out_line == RESPONSE_FRAME_END:
+                    break
+                output.append(out_line)
+
+            return '\n'.join(output)
+
+    def close(self):
+        # Ask the resident backend to save state and exit
+        proc, self._proc = self._proc, None
+        if proc is None:
+            return
+        try:
+            if proc.poll() is None:
+                proc.stdin.write("QUIT\n")
+                proc.stdin.flush()
+                proc.wait(timeout=self.timeout)
+        except Exception:
+            proc.kill()
+
+    def _execute_once(self, command):
         try:
             # Write the command to input file so C++ backend can read it
             with open(self.input_file, 'w', encoding='utf-8') as f:
@@ -21,7 +112,7 @@ class BackendInterface:
             result = subprocess.run([self.cpp_executable],
                                    capture_output=True,
                                    text=True,
-                                   timeout=5)
+                                   timeout=self.timeout)
 
             if result.returncode != 0:
                 return {"error": result.stderr.strip() or "Execution failed"}
@@ -51,38 +142,61 @@ class BackendInterface:
         if lines[0].startswith("ERROR"):
             return {"error": lines[0].replace("ERROR: ", "")}
 
-        cmd = command.strip().upper()
-        # Different commands produce different kinds of formatted output
-        if "SEARCHFILTER" in cmd:
-            return self._parse_search_results_extended(lines)
-
-        if "LISTALLFILTER" in cmd:
-            return self._parse_product_list_extended(lines)
-
-        if "SORT" in cmd:
-            return self._parse_sorted_results(lines)
-        if "AUTOCOMP" in cmd:
-            return self._parse_autocomp(lines)
-
-        if "SEARCHCAT" in cmd:
-            return self._parse_search_results(lines)
-        elif "LISTCAT" in cmd:
-            return self._parse_product_list(lines)
-        elif "SEARCH" in cmd:
-            return self._parse_search_results(lines)
-        elif "SHOWCART" in cmd:
-            return self._parse_cart(lines)
-        elif "CHECKOUT" in cmd:
-            return self._parse_checkout(lines)
-        elif "RECOMMEND" in cmd:
-            return self._parse_recommendations(lines)
-        elif "LISTALL" in cmd:
-            return self._parse_product_list(lines)
-        elif "ADD" in cmd or "REMOVE" in cmd:
-            return self._parse_cart_action(lines)
+        # Dispatch on the command word so query text like "sort" cannot pick the parser
+        words = command.strip().split(None, 1)
+        cmd = words[0].upper() if words else ""
+        parsers = {
+            "SEARCHFILTER": self._parse_search_results_extended,
+            "LISTALLFILTER": self._parse_product_list_extended,
+            "SORT": self._parse_sorted_results,
+            "AUTOCOMP": self._parse_autocomp,
+            "SEARCHCAT": self._parse_search_results,
+            "LISTCAT": self._parse_product_list,
+            "SEARCH": self._parse_search_results,
+            "SHOWCART": self._parse_cart,
+            "CHECKOUT": self._parse_checkout,
+            "RECOMMEND": self._parse_recommendations,
+            "LISTALL": self._parse_product_list,
+            "ADD": self._parse_cart_action,
+            "REMOVE": self._parse_cart_action,
+        }
+        if cmd in parsers:
+            result = parsers[cmd](lines)
+            # List commands end with PAGE|offset|count|total|cursor
+            page = self._parse_page(lines)
+            if page is not None:
+                result["page"] = page
+            return result
 
         return {"output": output}
 
+    def _parse_page(self, lines):
+        for line in reversed(lines):
+            if line.startswith("PAGE|"):
+                parts = line.split('|')
+                if len(parts) >= 5:
+                    return {
+                        "offset": int(parts[1]),
+                        "count": int(parts[2]),
+                        # '-' when the backend stopped at the end of the page
+                        "total": None if parts[3] == "-" else int(parts[3]),
+                        "cursor": None if parts[4] == "-" else parts[4]
+                    }
+        return None
+
+    def iter_pages(self, command, page_size=50):
+        # Yields one parsed page at a time, following the backend's continuation cursor
+        cursor = None
+        while True:
+            opts = f"limit={page_size}" + (f";cursor={cursor}" if cursor else "")
+            # Options follow the last '|', so a command that already has some gets ours appended
+            sep = ";" if "|" in command else " |"
+            result = self.execute_command(f"{command}{sep}{opts}")
+            yield result
+            cursor = result.get("page", {}).get("cursor")
+            if "error" in result or not cursor:
+                return
+
     def _extract_product_extended(self, parts):
          # Helper function for reading product fields with brand included
         name = parts[0]
@@ -182,14 +296,24 @@ class BackendInterface:
 
         items = []
         total = 0.0
+        suggestions = []
         if lines[0] == "CART_START":
-            for line in lines[1:]:
+            for i, line in enumerate(lines[1:], 1):
                 if line == "CART_END":
                     continue
                 if line.startswith("TOTAL:"):
 
                     # Extract cart total shown by backend
                     total = float(line.split(":")[1].strip())
+
+                    # "Complete your cart" products may follow the total
+                    if i + 1 < len(lines) and lines[i + 1] == "SUGGESTIONS":
+                        for row in lines[i + 2:]:
+                            if row == "SUGGESTIONS_END":
+                                break
+                            parts = row.split('|')
+                            if len(parts) >= 2:
+                                suggestions.append({"name": parts[0], "price": float(parts[1])})
                     break
                 parts = line.split('|')
                 if len(parts) >= 4:
@@ -199,7 +323,7 @@ class BackendInterface:
                         "price": float(parts[2]),
                         "subtotal": float(parts[3])
                     })
-        return {"items": items, "total": total}
+        return {"items": items, "total": total, "suggestions": suggestions}
 
     def _parse_checkout(self, lines):
         # Successful checkout response
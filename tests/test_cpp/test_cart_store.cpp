@@ -0,0 +1,47 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include "../../src/backend_cpp/cart_store.h"
+
+using namespace std;
+
+static string readAll(const string& filename) {
+    ifstream in(filename, ios::binary);
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main() {
+    const string file = "test_cart_store.txt";
+    remove(file.c_str());
+
+    {
+        CartStore store;
+        for (int i = 1; i <= 5; i++) store.submit(file, "Item|" + to_string(i) + "\n");
+
+        //a burst below the threshold is still waiting for the delay
+        bool deferred = readAll(file).empty();
+        this_thread::sleep_for(chrono::milliseconds(CART_FLUSH_DELAY_MS * 3));
+        if (deferred && readAll(file) == "Item|5\n") {
+            cout << "[PASS] Burst of changes is coalesced into the newest state.\n";
+        } else {
+            cout << "[FAIL] Batched cart write is wrong.\n";
+        }
+
+        //a synchronous write wins over anything still queued
+        store.submit(file, "Old|1\n");
+        store.writeNow(file, "Checkout|1\n");
+        store.submit(file, "Last|1\n");
+    }    //stopping writes what is pending
+
+    if (readAll(file) == "Last|1\n") {
+        cout << "[PASS] Pending changes are written on shutdown.\n";
+    } else {
+        cout << "[FAIL] Pending cart change was lost.\n";
+    }
+
+    remove(file.c_str());
+    return 0;
+}
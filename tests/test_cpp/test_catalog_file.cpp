@@ -0,0 +1,52 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include "../../src/backend_cpp/product.h"
+
+using namespace std;
+
+int main() {
+    {
+        ofstream out("test_catalog.txt");
+        out << "# comment\n"
+            << "Apple iPhone 15|79999.5|10|Electronics|Apple\n"
+            << "Cotton T-Shirt|499|250|Clothing|\n"
+            << "apple iphone 15|78999|7|Electronics|Apple\n";    //same name, replaces the first line
+    }
+
+    ProductManager text;
+    text.loadProducts("test_catalog.txt");
+    text.saveCatalogFile("test_catalog.cat");
+
+    //the binary file opens through the same call and gives back the same catalog
+    ProductManager binary;
+    bool loaded = binary.loadProducts("test_catalog.cat");
+    bool same = loaded && binary.size() == text.size();
+    for (uint32_t id = 0; same && id < text.size(); id++) {
+        const Product *a = text.getProduct(id), *b = binary.getProduct(id);
+        same = a->name == b->name && a->price == b->price && a->stock == b->stock &&
+               text.categoryName(*a) == binary.categoryName(*b) && text.brandName(*a) == binary.brandName(*b);
+    }
+    if (same && binary.size() == 2 && binary.findId("APPLE IPHONE 15") == 0 && binary.getProduct(0u)->stock == 7) {
+        cout << "[PASS] Binary catalog round-trips the text catalog.\n";
+    } else {
+        cout << "[FAIL] Binary catalog differs from the text catalog.\n";
+    }
+
+    //flip one byte of a column, the checksum must reject the file
+    {
+        fstream f("test_catalog.cat", ios::in | ios::out | ios::binary);
+        f.seekp(44);
+        f.put('\x7f');
+    }
+    ProductManager corrupt;
+    if (!corrupt.loadProducts("test_catalog.cat") && corrupt.size() == 0) {
+        cout << "[PASS] Corrupt binary catalog is rejected.\n";
+    } else {
+        cout << "[FAIL] Corrupt binary catalog was loaded.\n";
+    }
+
+    remove("test_catalog.txt");
+    remove("test_catalog.cat");
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include "../../src/backend_cpp/catalog_parser.h"
+
+using namespace std;
+
+int main() {
+    CatalogRow row;
+    bool ok = parseCatalogLine("  Apple iPhone 15 | 799.5|12abc |Electronics|Apple\r", row);
+    if (ok && row.name == "Apple iPhone 15" && row.price == 799.5 && row.stock == 12 &&
+        row.category == "Electronics" && row.brand == "Apple") {
+        cout << "[PASS] Fields are trimmed and numbers parsed in place.\n";
+    } else {
+        cout << "[FAIL] Line was not split correctly.\n";
+    }
+
+    //same rules as before: comments, blanks and short lines are skipped, bad numbers become 0
+    if (!parseCatalogLine("# comment|1|2|3", row) && !parseCatalogLine("", row) &&
+        !parseCatalogLine("A|1|2|", row) && parseCatalogLine("A|x|+3|Home", row) &&
+        row.price == 0.0 && row.stock == 3 && row.brand.empty()) {
+        cout << "[PASS] Malformed lines handled like the old loader.\n";
+    } else {
+        cout << "[FAIL] Malformed line handling changed.\n";
+    }
+
+    //chunked parsing keeps file order across the cut points
+    string text;
+    for (int i = 0; i < 1000; i++) text += "Item " + to_string(i) + "|" + to_string(i) + "|1|Home|Acme\n";
+    text += "Last|1|1|Home";    //no trailing newline
+    vector<CatalogRow> single = parseCatalog(text.data(), text.size(), 1);
+    vector<CatalogRow> split = parseCatalog(text.data(), text.size(), 4);
+    bool same = single.size() == 1001 && split.size() == single.size();
+    for (size_t i = 0; same && i < single.size(); i++)
+        same = single[i].name == split[i].name && single[i].price == split[i].price;
+    if (same && split.back().name == "Last") {
+        cout << "[PASS] Multi-threaded parse matches the single pass.\n";
+    } else {
+        cout << "[FAIL] Multi-threaded parse differs.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+#include "../../src/backend_cpp/column_store.h"
+#include "../../src/backend_cpp/product.h"
+
+using namespace std;
+
+int main() {
+    //more than one 64-row block, so the partial last block is covered too
+    NameDictionary categories, brands;
+    vector<Product> products(100);
+    for (int i = 0; i < 100; i++) {
+        products[i].name = "Item " + to_string(i);
+        products[i].price = i * 100;
+        products[i].stock = i % 10;
+        products[i].categoryId = categories.intern((i % 2 == 0) ? "Audio" : "Books");
+        products[i].brandId = brands.intern((i % 3 == 0) ? "Sony" : "boAt");
+    }
+
+    vector<const Product*> refs;
+    for (const Product &p : products) refs.push_back(&p);
+
+    ProductColumns columns;
+    columns.build(refs, categories, brands);
+
+    ProductFilters none;
+    if (columns.select(none).count() == 100) {
+        cout << "[PASS] Empty filter selects every row.\n";
+    } else {
+        cout << "[FAIL] Empty filter dropped rows.\n";
+    }
+
+    ProductFilters f;
+    f.min_price = 1000;
+    f.max_price = 8000;
+    f.category = "audio";
+    f.brands = {"SONY"};
+    vector<const Product*> out = columns.filter(f);
+
+    //even multiples of 3 between 10 and 80: 12, 18, ..., 78
+    bool ok = out.size() == 12;
+    for (size_t i = 0; ok && i < out.size(); i++) ok = out[i] == &products[12 + 6 * i];
+    if (ok) {
+        cout << "[PASS] Combined filters return matches in catalog order.\n";
+    } else {
+        cout << "[FAIL] Combined filters returned wrong rows.\n";
+    }
+
+    //every even row is Audio and every row is Sony or boAt, the unknown brand adds nothing
+    ProductFilters posted;
+    posted.category = "Audio";
+    posted.brands = {"sony", "BOAT", "Nokia"};
+    if (columns.rowsInCategory(categories.find("books")).size() == 50 && columns.filter(posted).size() == 50) {
+        cout << "[PASS] Posting lists cover category and brand union.\n";
+    } else {
+        cout << "[FAIL] Posting lists returned wrong rows.\n";
+    }
+
+    //narrow price band is answered from the price index, results still in catalog order
+    ProductFilters band;
+    band.min_price = 4050;
+    band.max_price = 4250;
+    band.category = "Books";
+    vector<const Product*> banded = columns.filter(band);
+    if (columns.countInPriceRange(4050, 4250) == 2 && banded.size() == 1 && banded[0] == &products[41]) {
+        cout << "[PASS] Price index finds the band.\n";
+    } else {
+        cout << "[FAIL] Price index returned wrong rows.\n";
+    }
+
+    ProductFilters unknown;
+    unknown.category = "Garden";
+    if (columns.filter(unknown).empty()) {
+        cout << "[PASS] Unknown category matches nothing.\n";
+    } else {
+        cout << "[FAIL] Unknown category matched rows.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include "../../src/backend_cpp/edit_distance.h"
+
+using namespace std;
+
+int main() {
+    if (editDistance("samsung", "samsng") == 1 && editDistance("kitten", "sitting") == 3) {
+        cout << "[PASS] Edit distance is exact for short words.\n";
+    } else {
+        cout << "[FAIL] Edit distance returned wrong value.\n";
+    }
+
+    //with a limit, anything farther is reported as limit + 1
+    if (editDistance("keyboard", "monitor", 2) == 3) {
+        cout << "[PASS] Edit distance stops at maxDistance.\n";
+    } else {
+        cout << "[FAIL] Edit distance ignored maxDistance.\n";
+    }
+
+    string longA(100, 'a');
+    string longB = longA;
+    longB[10] = 'b';
+    longB[90] = 'c';
+    if (editDistance(longA, longB, 5) == 2) {
+        cout << "[PASS] Banded edit distance works for long inputs.\n";
+    } else {
+        cout << "[FAIL] Banded edit distance returned wrong value.\n";
+    }
+
+    //length gap and distances beyond the 511 band are exact, not clamped
+    string shortX(100, 'x');
+    string padded = shortX + string(1000, 'y');
+    string allA(600, 'a'), allB(600, 'b');
+    if (editDistance(shortX, padded) == 1000 && editDistance(allA, allB) == 600 &&
+        editDistance(allA, allB, 550) == 551 && editDistance(allA + "c", allA) == 1) {
+        cout << "[PASS] Long inputs beyond the band are exact.\n";
+    } else {
+        cout << "[FAIL] Long inputs beyond the band returned wrong value.\n";
+    }
+
+    //nothing is within a negative bound
+    if (editDistance("same", "same", -1) == 0 && editDistance("same", "same", -3) == -2) {
+        cout << "[PASS] Negative bound reports maxDistance + 1.\n";
+    } else {
+        cout << "[FAIL] Negative bound reported a match.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <vector>
+#include "../../src/backend_cpp/fuzzy_index.h"
+
+using namespace std;
+
+int main() {
+    vector<Product> products(3);
+    products[0].name = "Samsung Galaxy S24";
+    products[1].name = "Apple iPhone 15";
+    products[2].name = "Samsung 45W Charger";
+
+    vector<const Product*> refs;
+    for (const Product &p : products) refs.push_back(&p);
+
+    FuzzySearchIndex index;
+    index.build(refs);
+
+    vector<const Product*> typo = index.search("samsng");
+    if (typo.size() == 2 && typo[0] == &products[0] && typo[1] == &products[2]) {
+        cout << "[PASS] Fuzzy index tolerates typos.\n";
+    } else {
+        cout << "[FAIL] Fuzzy index typo search returned wrong output.\n";
+    }
+
+    vector<const Product*> sub = index.search("phone 1");
+    if (sub.size() == 1 && sub[0] == &products[1]) {
+        cout << "[PASS] Fuzzy index substring search works.\n";
+    } else {
+        cout << "[FAIL] Fuzzy index substring search returned wrong output.\n";
+    }
+
+    //one and two character queries come straight from their posting list, no name is scanned
+    vector<const Product*> two = index.search("45", 0);
+    size_t checkedTwo = index.lastNamesChecked();
+    vector<const Product*> one = index.search("w", 0);
+    if (two.size() == 1 && two[0] == &products[2] && checkedTwo == 0 &&
+        one.size() == 1 && one[0] == &products[2] && index.lastNamesChecked() == 0) {
+        cout << "[PASS] Short queries use the gram postings.\n";
+    } else {
+        cout << "[FAIL] Short query scanned the names or matched wrong.\n";
+    }
+
+    return 0;
+}
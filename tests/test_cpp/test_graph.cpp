@@ -3,19 +3,68 @@
 
 using namespace std;
 
-int main() {
-    Graph g;
+static vector<uint32_t> ids(const Neighbors &row) {
+    return vector<uint32_t>(row.begin(), row.end());
+}
 
-    g.addEdge("Laptop", "Charger");
-    g.addEdge("Laptop", "Mouse");
+int main() {
+    RecommendationGraph g;
 
-    vector<string> neighbors = g.getNeighbors("Laptop");
+    //0 = Laptop, 1 = Charger, 2 = Mouse, 3 = Bag
+    g.build({{0, 1}, {0, 2}, {1, 0}, {3, 0}, {2, 2}}, 4);
 
-    if (neighbors.size() == 2) {
+    if (ids(g.getRecommendations(0)) == vector<uint32_t>({1, 2, 3}) && g.edgeCount() == 3) {
         cout << "[PASS] Graph adjacency list works correctly.\n";
     } else {
         cout << "[FAIL] Graph neighbors count incorrect.\n";
     }
 
+    //pairs are undirected, repeats are merged and self loops dropped
+    if (ids(g.getRecommendations(1)) == vector<uint32_t>({0}) && ids(g.getRecommendations(2)) == vector<uint32_t>({0}) &&
+        g.getRecommendations(0, 2).size() == 2 && g.getRecommendations(9).empty()) {
+        cout << "[PASS] Duplicate and reverse pairs are merged.\n";
+    } else {
+        cout << "[FAIL] Duplicate pairs were kept.\n";
+    }
+
+    //repeated pairs add up, rows are ordered by weight
+    g.build({{0, 1, 1.0f}, {0, 2, 1.5f}, {1, 0, 1.0f}, {0, 3, 0.5f}}, 4);
+    Neighbors row = g.getRecommendations(0);
+    if (ids(row) == vector<uint32_t>({1, 2, 3}) && row.weight(0) == 2.0f && row.weight(2) == 0.5f) {
+        cout << "[PASS] Neighbours are sorted by summed weight.\n";
+    } else {
+        cout << "[FAIL] Edge weights are wrong.\n";
+    }
+
+    //checkouts add bought-together weight that outranks the file edges and fades over time
+    g.build({{0, 1}, {0, 2}}, 4);
+    g.recordBasket({0, 3});
+    g.recordBasket({0, 3, 3});
+    vector<ScoredProduct> top;
+    g.topRecommendations(0, 2, top);
+    bool learnedFirst = top.size() == 2 && top[0].id == 3 && top[1].id == 1 && top[0].score > 1.99f;
+    for (int i = 0; i < 3000; i++) g.recordBasket({1, 2});
+    g.topRecommendations(0, 3, top);
+    if (learnedFirst && top.size() == 3 && top[0].id == 1 && top[2].id == 3 && top[2].score < 0.1f) {
+        cout << "[PASS] Learned co-purchases rank by decayed weight.\n";
+    } else {
+        cout << "[FAIL] Learned co-purchase ranking is wrong.\n";
+    }
+
+    //a checkout only changes the revision of rows it can reorder: its basket, and rows that mix
+    //file and learned weights (decay moves one against the other)
+    g.build({{0, 1}}, 4);
+    g.recordBasket({2, 3});
+    uint64_t r0 = g.productRevision(0), r2 = g.productRevision(2);
+    g.recordBasket({0, 1});
+    bool untouchedKept = g.productRevision(2) == r2 && g.productRevision(0) != r0;
+    r0 = g.productRevision(0);
+    g.recordBasket({2, 3});
+    if (untouchedKept && g.productRevision(2) != r2 && g.productRevision(0) != r0) {
+        cout << "[PASS] Checkouts only change the revisions of affected products.\n";
+    } else {
+        cout << "[FAIL] Product revisions are wrong.\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,41 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include "../../src/backend_cpp/product.h"
+#include "../../src/backend_cpp/trie.h"
+
+using namespace std;
+
+int main() {
+    {
+        ofstream out("test_names.txt");
+        out << "Ikigai by Héctor García|399|40|Books|\n"
+            << "Apple iPhone 15|79999|10|Electronics|Apple\n"
+            << "Man’s Search for Meaning|299|25|Books|\n";
+    }
+
+    ProductManager pm;
+    pm.loadProducts("test_names.txt");
+
+    if (pm.findId("apple IPHONE 15") == 1 && pm.findId("Apple iPhone") == ProductManager::NO_ID) {
+        cout << "[PASS] Name lookups ignore case.\n";
+    } else {
+        cout << "[FAIL] Case-insensitive lookup failed.\n";
+    }
+
+    //every spelling the trie accepts resolves to the same id
+    Trie trie;
+    trie.attach(pm);
+    for (const Product &p : pm.view()) trie.insert(p.id);
+    bool same = true;
+    for (const char *q : {"ikigai by hector garcia", "IKIGAI BY HÉCTOR GARCÍA", "man's search for meaning"})
+        same = same && pm.findId(q) != ProductManager::NO_ID && pm.findId(q) == trie.findWord(q);
+    if (same && pm.findId("Ikigai by Hector Garcia") == 0) {
+        cout << "[PASS] Accented and plain spellings find the same product.\n";
+    } else {
+        cout << "[FAIL] Name index and trie disagree on folded names.\n";
+    }
+
+    remove("test_names.txt");
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <chrono>
+#include "../../src/backend_cpp/personalized_rank.h"
+
+using namespace std;
+
+static bool has(const vector<ScoredProduct> &out, uint32_t id) {
+    for (const ScoredProduct &s : out)
+        if (s.id == id) return true;
+    return false;
+}
+
+int main() {
+    RecommendationGraph g;
+    PersonalizedRanker ranker(g);
+    vector<ScoredProduct> out;
+
+    //0 = Phone, 1 = Case, 2 = Charger, 3 = Cable (only reached through the charger), 4 = Sofa
+    g.build({{0, 1}, {0, 2}, {2, 3}, {4, 4}}, 5);
+    ranker.rank({0}, 5, out);
+    if (out.size() == 3 && !has(out, 0) && has(out, 3) && !has(out, 4) && out.back().id == 3) {
+        cout << "[PASS] Suggestions reach two hops and skip the cart.\n";
+    } else {
+        cout << "[FAIL] Wrong suggestions for a one item cart.\n";
+    }
+
+    //vectors are cleared after every query, so a repeat gives the same scores
+    vector<ScoredProduct> again;
+    ranker.rank({0}, 5, again);
+    bool same = again.size() == out.size();
+    for (size_t i = 0; same && i < out.size(); i++) same = again[i].id == out[i].id && again[i].score == out[i].score;
+    if (same) {
+        cout << "[PASS] Repeated queries give identical results.\n";
+    } else {
+        cout << "[FAIL] State leaked between queries.\n";
+    }
+
+    //learned co-purchases count as edges too
+    g.recordBasket({1, 4});
+    ranker.rank({1}, 5, out);
+    if (has(out, 4) && !has(out, 1)) {
+        cout << "[PASS] Learned pairs are walked.\n";
+    } else {
+        cout << "[FAIL] Learned pairs were ignored.\n";
+    }
+
+    //a long chain with a zero budget still stops and answers
+    vector<GraphEdge> chain;
+    for (uint32_t i = 0; i + 1 < 200000; i++) chain.push_back({i, i + 1});
+    g.build(chain, 200000);
+    auto start = chrono::steady_clock::now();
+    ranker.rank({0, 100000}, 5, out, chrono::microseconds(0));
+    auto took = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    if (!out.empty() && ranker.lastPushes() <= 16 && took < 50) {
+        cout << "[PASS] Time budget bounds the walk.\n";
+    } else {
+        cout << "[FAIL] Walk ran past its budget.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <iostream>
+#include <vector>
+#include "../../src/backend_cpp/product.h"
+
+using namespace std;
+
+int main() {
+    vector<Product> products(5);
+    for (int i = 0; i < 5; i++) {
+        products[i].name = "Item " + to_string(i);
+        products[i].price = 100 * (i + 1);
+        products[i].stock = i;
+    }
+
+    vector<const Product*> refs;
+    for (const Product &p : products) refs.push_back(&p);
+    ProductView all(refs);
+
+    //the view hands out the stored products themselves, not copies
+    ProductView page = all.page(3, 10);
+    if (page.size() == 2 && &page[0] == &products[3] && all.page(9, 1).empty()) {
+        cout << "[PASS] Pages are clamped windows into the same storage.\n";
+    } else {
+        cout << "[FAIL] Page window is wrong.\n";
+    }
+
+    //filters run while iterating and can be chained
+    auto cheapInStock = all.where([](const Product &p) { return p.stock > 0; })
+                           .where([](const Product &p) { return p.price <= 300; });
+    vector<const Product*> seen;
+    for (const Product &p : cheapInStock) seen.push_back(&p);
+    if (seen == vector<const Product*>({&products[1], &products[2]})) {
+        cout << "[PASS] Chained filters keep view order.\n";
+    } else {
+        cout << "[FAIL] Chained filters returned wrong products.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include "../../src/backend_cpp/recommend_cache.h"
+
+using namespace std;
+
+int main() {
+    RecommendCache cache(2);
+
+    //hits need the same product, maxResults and graph revision
+    cache.store(7, 5, 1, "RECOMMENDATIONS\nCase|1999\nRECOMMEND_END\n");
+    const string *hit = cache.lookup(7, 5, 1);
+    if (hit && *hit == "RECOMMENDATIONS\nCase|1999\nRECOMMEND_END\n" && !cache.lookup(7, 3, 1) &&
+        !cache.lookup(7, 5, 2) && !cache.lookup(8, 5, 1)) {
+        cout << "[PASS] Responses are cached per product and maxResults.\n";
+    } else {
+        cout << "[FAIL] Cache lookup is wrong.\n";
+    }
+
+    //a full table evicts the entry that was not used since the hand last passed
+    cache.store(8, 5, 1, "b");
+    cache.lookup(7, 5, 1);
+    cache.store(9, 5, 1, "c");
+    if (cache.lookup(7, 5, 1) && !cache.lookup(8, 5, 1) && cache.lookup(9, 5, 1)) {
+        cout << "[PASS] CLOCK keeps recently used responses.\n";
+    } else {
+        cout << "[FAIL] Wrong entry evicted.\n";
+    }
+
+    //a graph change (a checkout that touches the product bumps its revision) turns the cached responses into misses
+    if (!cache.lookup(7, 5, 2) && !cache.lookup(9, 5, 2)) {
+        cout << "[PASS] A new graph revision invalidates responses.\n";
+    } else {
+        cout << "[FAIL] Stale response served.\n";
+    }
+
+    //a stale entry is refreshed in place
+    cache.store(7, 5, 2, "e");
+    hit = cache.lookup(7, 5, 2);
+    if (hit && *hit == "e" && cache.lookup(9, 5, 1)) {
+        cout << "[PASS] Stale responses are replaced.\n";
+    } else {
+        cout << "[FAIL] Refresh failed.\n";
+    }
+
+    //maxResults beyond the fixed bound is simply not cached
+    cache.store(7, RECOMMEND_CACHE_MAX_RESULTS + 1, 2, "f");
+    if (!cache.lookup(7, RECOMMEND_CACHE_MAX_RESULTS + 1, 2) && !cache.lookup(7, 1000000, 2)) {
+        cout << "[PASS] Oversized maxResults bypasses the cache.\n";
+    } else {
+        cout << "[FAIL] Oversized maxResults was cached.\n";
+    }
+
+    return 0;
+}
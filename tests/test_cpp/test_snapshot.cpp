@@ -0,0 +1,76 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include "../../src/backend_cpp/snapshot.h"
+#include "../../src/backend_cpp/product.h"
+#include "../../src/backend_cpp/trie.h"
+#include "../../src/backend_cpp/graph.h"
+
+using namespace std;
+
+static string readAll(const string& filename) {
+    ifstream in(filename, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+static void writeAll(const string& filename, const string& bytes) {
+    ofstream out(filename, ios::binary | ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+int main() {
+    {
+        ofstream out("test_snapshot.txt");
+        out << "Apple iPhone 15|79999|10|Electronics|Apple\n"
+            << "Spigen iPhone 15 Case|1999|50|Accessories|Spigen\n";
+    }
+
+    ProductManager pm;
+    pm.loadProducts("test_snapshot.txt");
+    Trie trie;
+    trie.attach(pm);
+    for (const Product &p : pm.view()) trie.insert(p.id);
+    RecommendationGraph graph;
+    graph.build({{0, 1}}, pm.size());
+
+    SnapshotSource source;
+    getFileStamp("test_snapshot.txt", source.products);
+    saveSnapshot("test_snapshot.snap", source, pm, trie, graph);
+
+    ProductManager pm2;
+    Trie trie2;
+    trie2.attach(pm2);
+    RecommendationGraph graph2;
+    bool loaded = loadSnapshot("test_snapshot.snap", source, pm2, trie2, graph2);
+    if (loaded && pm2.size() == 2 && pm2.findId("spigen iphone 15 case") == 1 && graph2.edgeCount() == 1) {
+        cout << "[PASS] Snapshot round-trips the catalog.\n";
+    } else {
+        cout << "[FAIL] Snapshot did not load.\n";
+    }
+
+    //a torn write or a flipped byte is caught by the checksum, before any section is read
+    string bytes = readAll("test_snapshot.snap");
+    writeAll("test_snapshot.snap", bytes.substr(0, bytes.size() / 2));
+    bool torn = loadSnapshot("test_snapshot.snap", source, pm2, trie2, graph2);
+    bytes[bytes.size() - 12] ^= 0x40;
+    writeAll("test_snapshot.snap", bytes);
+    bool flipped = loadSnapshot("test_snapshot.snap", source, pm2, trie2, graph2);
+    if (!torn && !flipped) {
+        cout << "[PASS] Corrupt snapshots are rejected.\n";
+    } else {
+        cout << "[FAIL] Corrupt snapshot was accepted.\n";
+    }
+
+    //a count larger than the rest of the file fails the reader instead of sizing an allocation
+    char forged[8] = {'\xff', '\xff', '\xff', '\xff', 1, 2, 3, 4};
+    SnapshotReader r(forged, sizeof(forged));
+    if (r.getCount(sizeof(uint32_t)) == 0 && !r.ok()) {
+        cout << "[PASS] Oversized counts are rejected.\n";
+    } else {
+        cout << "[FAIL] Oversized count accepted.\n";
+    }
+
+    remove("test_snapshot.txt");
+    remove("test_snapshot.snap");
+    return 0;
+}
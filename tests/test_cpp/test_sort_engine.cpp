@@ -0,0 +1,40 @@
+#include <iostream>
+#include <vector>
+#include "../../src/backend_cpp/sort_engine.h"
+
+using namespace std;
+
+int main() {
+    vector<Product> products(4);
+    products[0].name = "Mouse";    products[0].price = 500;   products[0].stock = 10;
+    products[1].name = "laptop";   products[1].price = 45000; products[1].stock = 5;
+    products[2].name = "Keyboard"; products[2].price = 500;   products[2].stock = 30;
+    products[3].name = "Charger";  products[3].price = 1500;  products[3].stock = 10;
+
+    vector<const Product*> refs;
+    for (const Product &p : products) refs.push_back(&p);
+
+    vector<uint32_t> byPrice = sortPermutation(refs, sortKeysFor(SORT_PRICE_ASC));
+    if (byPrice == vector<uint32_t>({0, 2, 3, 1})) {
+        cout << "[PASS] Price sort is stable.\n";
+    } else {
+        cout << "[FAIL] Price sort returned wrong order.\n";
+    }
+
+    vector<uint32_t> byName = sortPermutation(refs, sortKeysFor(SORT_NAME_ASC));
+    if (byName == vector<uint32_t>({3, 2, 1, 0})) {
+        cout << "[PASS] Name sort ignores case.\n";
+    } else {
+        cout << "[FAIL] Name sort returned wrong order.\n";
+    }
+
+    //stock high to low, then cheapest first
+    vector<uint32_t> multi = sortPermutation(refs, {{FIELD_STOCK, true}, {FIELD_PRICE, false}});
+    if (multi == vector<uint32_t>({2, 0, 3, 1})) {
+        cout << "[PASS] Multi-key sort works.\n";
+    } else {
+        cout << "[FAIL] Multi-key sort returned wrong order.\n";
+    }
+
+    return 0;
+}
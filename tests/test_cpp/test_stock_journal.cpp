@@ -0,0 +1,86 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include "../../src/backend_cpp/product.h"
+#include "../../src/backend_cpp/stock_journal.h"
+#include "../../src/backend_cpp/catalog_file.h"
+
+using namespace std;
+
+static string readAll(const string& filename) {
+    ifstream in(filename, ios::binary);
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main() {
+    {
+        ofstream out("test_journal_catalog.txt");
+        out << "# -------- PHONES --------\n"
+            << "OnePlus 12|64999|65|Electronics|OnePlus\n"
+            << "\n"
+            << "Apple iPhone 15|79999|40|Electronics|Apple\n";
+    }
+    remove("test_stock_journal.txt");
+
+    {
+        ProductManager pm;
+        pm.loadProducts("test_journal_catalog.txt");
+        StockJournal journal(pm);
+        journal.open("test_stock_journal.txt", "test_journal_catalog.txt");
+        pm.updateStock(0u, -3);
+        journal.append({0u});
+        pm.updateStock(1u, -1);
+        journal.append({1u});
+    }    //closing syncs, the catalog file is untouched
+
+    //a fresh start replays both checkouts on top of the unchanged catalog
+    ProductManager pm;
+    pm.loadProducts("test_journal_catalog.txt");
+    StockJournal journal(pm);
+    vector<uint32_t> changed = journal.open("test_stock_journal.txt", "test_journal_catalog.txt");
+    if (changed.size() == 2 && pm.getProduct(0u)->stock == 62 && pm.getProduct(1u)->stock == 39) {
+        cout << "[PASS] Journal replays stock changes at startup.\n";
+    } else {
+        cout << "[FAIL] Journal replay gave wrong stock.\n";
+    }
+
+    //compaction only touches the stock fields and empties the journal
+    string expected = "# -------- PHONES --------\n"
+                      "OnePlus 12|64999|62|Electronics|OnePlus\n"
+                      "\n"
+                      "Apple iPhone 15|79999|39|Electronics|Apple\n";
+    string header = "#catalog " + to_string(catalogChecksum(expected.data(), expected.size())) + "\n";
+    if (journal.compact() && readAll("test_journal_catalog.txt") == expected && journal.size() == header.size() &&
+        readAll("test_stock_journal.txt") == header) {
+        cout << "[PASS] Compaction keeps comments and order.\n";
+    } else {
+        cout << "[FAIL] Compaction rewrote the catalog wrongly.\n";
+    }
+
+    //a checkout after compaction, then the catalog is replaced behind the journal's back
+    pm.updateStock(0u, -2);
+    journal.append({0u});
+    journal.close();
+    {
+        ofstream out("test_journal_catalog.txt");
+        out << "OnePlus 12|64999|100|Electronics|OnePlus\n"
+            << "Apple iPhone 15|79999|100|Electronics|Apple\n";
+    }
+    ProductManager fresh;
+    fresh.loadProducts("test_journal_catalog.txt");
+    StockJournal stale(fresh);
+    changed = stale.open("test_stock_journal.txt", "test_journal_catalog.txt");
+    if (changed.empty() && fresh.getProduct(0u)->stock == 100 && stale.size() < 64) {
+        cout << "[PASS] Journal of another catalog is dropped.\n";
+    } else {
+        cout << "[FAIL] Stale journal was replayed onto a new catalog.\n";
+    }
+    stale.close();
+
+    remove("test_journal_catalog.txt");
+    remove("test_stock_journal.txt");
+    return 0;
+}
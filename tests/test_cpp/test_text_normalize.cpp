@@ -0,0 +1,27 @@
+#include <iostream>
+#include <string>
+#include "../../src/backend_cpp/text_normalize.h"
+
+using namespace std;
+
+int main() {
+    if (foldKey("Ikigai by H\xC3\xA9" "ctor Garc\xC3\xAD" "a") == "ikigai by hector garcia") {
+        cout << "[PASS] Accents and case are folded.\n";
+    } else {
+        cout << "[FAIL] Accent folding returned wrong output.\n";
+    }
+
+    if (foldKey("Man\xE2\x80\x99s Search") == "man's search") {
+        cout << "[PASS] Curly apostrophe is normalized.\n";
+    } else {
+        cout << "[FAIL] Apostrophe folding returned wrong output.\n";
+    }
+
+    if (foldKey("iPhone 15") != foldKey("iPhone")) {
+        cout << "[PASS] Digits and spaces stay part of the key.\n";
+    } else {
+        cout << "[FAIL] Different names folded to the same key.\n";
+    }
+
+    return 0;
+}
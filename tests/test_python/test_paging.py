@@ -0,0 +1,46 @@
+import unittest
+from src.gui_python.backend_interface import BackendInterface
+
+class TestPaging(unittest.TestCase):
+
+    def setUp(self):
+        self.backend = BackendInterface("ecommerce", "input.txt", "output.txt")
+
+    def test_parse_page(self):
+        page = self.backend._parse_page(["SEARCH_RESULTS", "SEARCH_END", "PAGE|0|2|5|c2"])
+        self.assertEqual(page, {"offset": 0, "count": 2, "total": 5, "cursor": "c2"})
+
+    def test_parse_last_page_without_total(self):
+        page = self.backend._parse_page(["CATEGORY_SEARCH_END", "PAGE|4|1|-|-"])
+        self.assertIsNone(page["total"])
+        self.assertIsNone(page["cursor"])
+
+    def test_iter_pages_follows_cursor(self):
+        sent = []
+        replies = [{"page": {"cursor": "c2"}}, {"page": {"cursor": "c4"}}, {"page": {"cursor": None}}]
+
+        def fake_execute(command):
+            sent.append(command)
+            return replies[len(sent) - 1]
+
+        self.backend.execute_command = fake_execute
+        pages = list(self.backend.iter_pages("LISTALL", 2))
+
+        self.assertEqual(len(pages), 3)
+        self.assertEqual(sent, ["LISTALL |limit=2", "LISTALL |limit=2;cursor=c2", "LISTALL |limit=2;cursor=c4"])
+
+    def test_iter_pages_keeps_existing_options(self):
+        sent = []
+
+        def fake_execute(command):
+            sent.append(command)
+            return {"page": {"cursor": None}}
+
+        self.backend.execute_command = fake_execute
+        list(self.backend.iter_pages("SEARCHFILTER lap | min_price=100", 10))
+
+        # paging options join the filters after the last '|' instead of starting a new segment
+        self.assertEqual(sent, ["SEARCHFILTER lap | min_price=100;limit=10"])
+
+if __name__ == "__main__":
+    unittest.main()